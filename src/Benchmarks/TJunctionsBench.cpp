@@ -0,0 +1,92 @@
+// Times 'CleanUpMesh' (vertex welding + T-junction splitting, see 'RemoveTJunctions') on a synthetic mesh.
+// Usage: TJunctionsBench [cells] [runs], 450 cells (default) make a mesh of about 1M triangles.
+#include <Unvoxeller/ScenePostprocessing.h>
+#include <Unvoxeller/Log/Log.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Grid of 'cells' x 'cells' unit cells on the XZ plane, every other cell split in 2x2 half size quads, so every unit cell
+// next to a split one has a T-junction in the middle of its sides. Quads aren't welded, like the ones 'MeshBuilder' makes.
+static UnvoxMesh GetPlaneMesh(s32 cells)
+{
+	UnvoxMesh mesh{};
+	mesh.IndicesPerFace = 3;
+
+	const size_t quads = size_t(cells) * cells * 5 / 2 + 4;
+	mesh.Vertices.reserve(quads * 4);
+	mesh.Normals.reserve(quads * 4);
+	mesh.UVs.reserve(quads * 4);
+	mesh.Indices.reserve(quads * 6);
+
+	const auto addQuad = [&mesh](f32 x, f32 z, f32 size)
+	{
+		const u32 first = static_cast<u32>(mesh.Vertices.size());
+
+		mesh.Vertices.push_back({ x, 0.0f, z });
+		mesh.Vertices.push_back({ x + size, 0.0f, z });
+		mesh.Vertices.push_back({ x + size, 0.0f, z + size });
+		mesh.Vertices.push_back({ x, 0.0f, z + size });
+
+		for (s32 i = 0; i < 4; ++i)
+		{
+			mesh.Normals.push_back({ 0.0f, 1.0f, 0.0f });
+			mesh.UVs.push_back({ (i == 1 || i == 2) ? 1.0f : 0.0f, i >= 2 ? 1.0f : 0.0f });
+		}
+
+		mesh.Indices.insert(mesh.Indices.end(), { first, first + 2, first + 1, first, first + 3, first + 2 });
+	};
+
+	for (s32 z = 0; z < cells; ++z)
+	{
+		for (s32 x = 0; x < cells; ++x)
+		{
+			if ((x + z) & 1)
+			{
+				addQuad(f32(x), f32(z), 1.0f);
+			}
+			else
+			{
+				for (s32 i = 0; i < 4; ++i)
+				{
+					addQuad(x + (i & 1) * 0.5f, z + (i >> 1) * 0.5f, 0.5f);
+				}
+			}
+		}
+	}
+
+	return mesh;
+}
+
+int main(int argc, char** argv)
+{
+	VoxellerApp::init();
+
+	const s32 cells = argc > 1 ? std::max(1, std::atoi(argv[1])) : 450;
+	const s32 runs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 3;
+
+	const UnvoxMesh source = GetPlaneMesh(cells);
+	std::printf("Plane: %d x %d cells, vertices: %zu, triangles: %zu\n", cells, cells, source.Vertices.size(), source.GetFaceCount());
+
+	f64 best = 0.0;
+	f64 total = 0.0;
+
+	for (s32 run = 0; run < runs; ++run)
+	{
+		UnvoxMesh mesh = source;
+
+		const auto start = std::chrono::steady_clock::now();
+		CleanUpMesh(&mesh);
+		const f64 seconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+
+		best = run == 0 ? seconds : std::min(best, seconds);
+		total += seconds;
+
+		std::printf("Run %d: %.3f s, vertices: %zu, triangles: %zu\n", run, seconds, mesh.Vertices.size(), mesh.GetFaceCount());
+	}
+
+	std::printf("CleanUpMesh best: %.3f s, average: %.3f s\n", best, total / runs);
+
+	return 0;
+}
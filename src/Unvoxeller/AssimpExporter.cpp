@@ -6,10 +6,104 @@
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/material.h>
 #include <Unvoxeller/Log/Log.h>
+#include <Unvoxeller/VertexQuantizer.h>
 
 namespace Unvoxeller
 {
-	static std::vector<aiScene*> GetAssimpScene(const std::string& name, const ConvertOptions& options, const std::vector<std::shared_ptr<UnvoxScene>>& unvoxScenes)
+	// Assimp copy of 'mesh', the scene materials are only checked.
+	static aiMesh* GetAssimpMesh(const UnvoxMesh& mesh, const UnvoxScene& scene, const ConvertOptions& options)
+	{
+		// Assimp has no quantized attributes, the floats are restored from a copy so the scene stays quantized.
+		UnvoxMesh dequantized{};
+		if (mesh.IsQuantized())
+		{
+			dequantized.Quantized = mesh.Quantized;
+			VertexQuantizer::Dequantize(dequantized);
+		}
+
+		const UnvoxMesh& attributes = mesh.IsQuantized() ? dequantized : mesh;
+
+		aiMesh* meshOut = new aiMesh();
+		
+		meshOut->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+		meshOut->mNumVertices = (unsigned int)attributes.Vertices.size();
+		meshOut->mNumFaces = static_cast<u32>(mesh.GetFaceCount());
+		meshOut->mFaces = new aiFace[meshOut->mNumFaces];
+		meshOut->mVertices = new aiVector3D[attributes.Vertices.size()];
+		meshOut->mNormals = new aiVector3D[attributes.Normals.size()];
+		
+		for (size_t i = 0; i < attributes.Vertices.size(); i++)
+		{
+			const auto& vert = attributes.Vertices[i];
+			meshOut->mVertices[i] = { vert.x, vert.y, vert.z };
+		}
+		
+		for (size_t i = 0; i < attributes.Normals.size(); i++)
+		{
+			const auto& norm = attributes.Normals[i];
+			meshOut->mNormals[i] = { norm.x, norm.y, norm.z };
+		}
+
+		// Assimp owns an index array per face
+		const u32 faceSize = mesh.IndicesPerFace;
+		for (u32 i = 0; i < meshOut->mNumFaces; i++)
+		{
+			aiFace& oFace = meshOut->mFaces[i];
+			oFace.mNumIndices = faceSize;
+			oFace.mIndices = new u32[faceSize];
+
+			for (u32 j = 0; j < faceSize; j++)
+			{
+				oFace.mIndices[j] = mesh.GetIndex(size_t(i) * faceSize + j);
+			}
+		}
+
+		u32 uvChannel = 0;
+
+		if (attributes.UVs.size() > 0)
+		{
+			meshOut->mTextureCoords[uvChannel] = new aiVector3D[attributes.UVs.size()];
+			meshOut->mNumUVComponents[uvChannel] = 2;
+
+			for (size_t i = 0; i < attributes.UVs.size(); i++)
+			{
+				const auto& uv = attributes.UVs[i];
+				meshOut->mTextureCoords[uvChannel][i] = { uv.x, uv.y, 0 };
+			}
+
+			uvChannel++;
+		}
+
+		if (mesh.Colors.size() > 0)
+		{
+			meshOut->mColors[0] = new aiColor4D[mesh.Colors.size()];
+
+			for (size_t i = 0; i < mesh.Colors.size(); i++)
+			{
+				const auto& col = mesh.Colors[i];
+				meshOut->mColors[0][i] = { col.r / 255.0f, col.g / 255.0f, col.b / 255.0f, col.a / 255.0f };
+			}
+		}
+
+		// Raw palette indices go in the next uv channel (u = index)
+		if (mesh.ColorIndices.size() > 0)
+		{
+			meshOut->mTextureCoords[uvChannel] = new aiVector3D[mesh.ColorIndices.size()];
+			meshOut->mNumUVComponents[uvChannel] = 1;
+
+			for (size_t i = 0; i < mesh.ColorIndices.size(); i++)
+			{
+				meshOut->mTextureCoords[uvChannel][i] = { static_cast<f32>(mesh.ColorIndices[i]), 0, 0 };
+			}
+		}
+
+		const bool validMaterial = mesh.MaterialIndex >= 0 && mesh.MaterialIndex < static_cast<s32>(scene.Materials.size());
+		meshOut->mMaterialIndex = options.Meshing.GenerateMaterials && validMaterial ? mesh.MaterialIndex : 0;
+
+		return meshOut;
+	}
+
+	static std::vector<aiScene*> GetAssimpScene(const std::string& name, const std::string& textureExtension, const ConvertOptions& options, const std::vector<std::shared_ptr<UnvoxScene>>& unvoxScenes)
 	{
 		aiMatrix4x4 scaleMat;
 		aiMatrix4x4::Scaling(aiVector3D(options.Scale.x, options.Scale.y, options.Scale.z), scaleMat);
@@ -49,76 +143,75 @@ namespace Unvoxeller
 			sceneOut->mRootNode->mTransformation = {};   // identity
 			// ** zero out the root node�s mesh list **
 			sceneOut->mRootNode->mNumMeshes = 0;
-			sceneOut->mNumMeshes = scene->Meshes.size();
-			sceneOut->mMeshes = new aiMesh*[scene->Meshes.size()];
-			
+			// LOD meshes go after the scene ones
+			const auto meshes = scene->GetAllMeshes();
+			sceneOut->mNumMeshes = static_cast<u32>(meshes.size());
+			sceneOut->mMeshes = new aiMesh*[meshes.size()];
+
 			std::vector<aiNode*> nodes{};
-			for (size_t i = 0; i < scene->Meshes.size(); i++)
+			for (size_t i = 0; i < meshes.size(); i++)
 			{
+				sceneOut->mMeshes[i] = GetAssimpMesh(*meshes[i], *scene, options);
+
 				auto child = new aiNode();
 				child->mNumMeshes = 1;
 				child->mMeshes = new u32[1] { static_cast<u32>(i) };
 				nodes.push_back(child);
-				const auto mesh = scene->Meshes[i];
-
-				aiMesh* meshOut = new aiMesh();
-				
-				meshOut->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
-				meshOut->mNumVertices = (unsigned int)mesh->Vertices.size();
-				meshOut->mNumFaces = mesh->Faces.size();
-				meshOut->mFaces = new aiFace[mesh->Faces.size()];
-				meshOut->mVertices = new aiVector3D[mesh->Vertices.size()];
-				meshOut->mNormals = new aiVector3D[mesh->Normals.size()];
-				meshOut->mTextureCoords[0] = new aiVector3D[mesh->UVs.size()];
-				meshOut->mNumUVComponents[0] = 2;
-				
-				sceneOut->mMeshes[i] = meshOut;
-
-				for (size_t i = 0; i < mesh->Vertices.size(); i++)
-				{
-					const auto& vert = mesh->Vertices[i];
-					meshOut->mVertices[i] = { vert.x, vert.y, vert.z };
-				}
-				
-				for (size_t i = 0; i < mesh->Normals.size(); i++)
-				{
-					const auto& norm = mesh->Normals[i];
-					meshOut->mNormals[i] = { norm.x, norm.y, norm.z };
-				}
+			}
 
-				for (size_t i = 0; i < mesh->Faces.size(); i++)
-				{
-					const auto& face = mesh->Faces[i];
-					aiFace oFace;
-					oFace.mNumIndices = static_cast<u32>(face.Indices.size());
-					oFace.mIndices = new u32[face.Indices.size()];
-					std::copy(face.Indices.begin(), face.Indices.end(), oFace.mIndices);
-					meshOut->mFaces[i] = oFace;
-				}
+			// Every LOD gets a node with its meshes, named like engines expect them: '<name>_LOD0' holds the full meshes
+			if (!scene->Lods.empty())
+			{
+				const std::string sceneName = name + (unvoxScenes.size() > 1 ? "_" + std::to_string(i) : "");
+				std::vector<aiNode*> lodNodes{};
+				size_t firstNode = 0;
 
-				for (size_t i = 0; i < mesh->UVs.size(); i++)
+				for (size_t l = 0; l <= scene->Lods.size(); l++)
 				{
-					const auto& uv = mesh->UVs[i];
-					meshOut->mTextureCoords[0][i] = { uv.x, uv.y, 0 };
+					// Downsampled LODs can have a different mesh count than the scene
+					const size_t meshCount = l == 0 ? scene->Meshes.size() : scene->Lods[l - 1].Meshes.size();
+
+					auto lodNode = new aiNode();
+					lodNode->mName = sceneName + "_LOD" + std::to_string(l == 0 ? 0 : scene->Lods[l - 1].Level);
+					lodNode->addChildren(static_cast<u32>(meshCount), nodes.data() + firstNode);
+					lodNodes.push_back(lodNode);
+					firstNode += meshCount;
 				}
 
-				if (options.Meshing.GenerateMaterials)
+				nodes = std::move(lodNodes);
+			}
+
+			if (options.Meshing.GenerateMaterials && scene->Materials.size() > 0)
+			{
+				// Materials point to the texture (atlas page) their meshes were built for.
+				sceneOut->mNumMaterials = static_cast<u32>(scene->Materials.size());
+				sceneOut->mMaterials = new aiMaterial * [scene->Materials.size()];
+
+				for (size_t m = 0; m < scene->Materials.size(); m++)
 				{
-					const aiString texPath((name + ".png"));//(scene->Textures[scene->Materials[mesh->MaterialIndex]->TextureIndex]->Name.data());
-					
+					const auto& material = scene->Materials[m];
+					const s32 texIndex = material ? material->TextureIndex : 0;
+					const bool hasTexture = texIndex >= 0 && texIndex < static_cast<s32>(scene->Textures.size()) && scene->Textures[texIndex];
+					const std::string textureName = hasTexture && !scene->Textures[texIndex]->Name.empty() ? scene->Textures[texIndex]->Name : name;
+
+					const aiString texPath(textureName + textureExtension);
+
 					aiMaterial* mat = new aiMaterial();
-					mat->AddProperty(&texPath, AI_MATKEY_TEXTURE(aiTextureType_DIFFUSE, 0));
 
-					// Since the meshes will be exported separatelly, always create a material per mesh
-					sceneOut->mNumMaterials = 1;
-					sceneOut->mMaterials = new aiMaterial * [1] { mat };
-				}
-				else
-				{
-					sceneOut->mNumMaterials = 0;
-					sceneOut->mMaterials = nullptr;
+					// Vertex colors don't have textures to point to
+					if (hasTexture || !options.Meshing.VertexColors)
+					{
+						mat->AddProperty(&texPath, AI_MATKEY_TEXTURE(aiTextureType_DIFFUSE, 0));
+					}
+
+					sceneOut->mMaterials[m] = mat;
 				}
 			}
+			else
+			{
+				sceneOut->mNumMaterials = 0;
+				sceneOut->mMaterials = nullptr;
+			}
 
 			sceneOut->mRootNode->addChildren(nodes.size(), std::move(nodes.data())); // Overwrite to set the index to 0
 
@@ -179,7 +272,7 @@ namespace Unvoxeller
 
 		u32 preprocess = 0;
 
-		const auto assimpScenes = GetAssimpScene(options.OutputName, cOptions, scenes);
+		const auto assimpScenes = GetAssimpScene(options.OutputName, GetTextureFileExtension(options.TexturesFormat), cOptions, scenes);
 
 		for (size_t i = 0; i < assimpScenes.size(); i++)
 		{
@@ -0,0 +1,925 @@
+#include <Unvoxeller/BlockCompressor.h>
+#include <Unvoxeller/ParallelFor.h>
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstring>
+
+namespace Unvoxeller
+{
+	static constexpr s32 BLOCK_TEXELS = 16;
+
+	// BC7 2 and 4 bits index interpolation weights (out of 64).
+	static constexpr s32 BC7_WEIGHTS2[4] = { 0, 21, 43, 64 };
+	static constexpr s32 BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	static inline s32 Expand5(s32 value) { return (value << 3) | (value >> 2); }
+	static inline s32 Expand6(s32 value) { return (value << 2) | (value >> 4); }
+
+	static inline s32 Quantize(s32 value, s32 maxValue)
+	{
+		return std::clamp((value * maxValue + 127) / 255, 0, maxValue);
+	}
+
+	// Endpoint pair (low, high) whose 2/3 : 1/3 BC1 interpolation is closest to every 8 bit value, voxel atlases are mostly solid blocks.
+	struct SolidBC1Table
+	{
+		std::array<std::array<u8, 2>, 256> Match5{};
+		std::array<std::array<u8, 2>, 256> Match6{};
+
+		SolidBC1Table()
+		{
+			Build(Match5, 31, Expand5);
+			Build(Match6, 63, Expand6);
+		}
+
+		template<typename Expand>
+		static void Build(std::array<std::array<u8, 2>, 256>& table, s32 maxValue, Expand expand)
+		{
+			for (s32 value = 0; value < 256; ++value)
+			{
+				s32 bestError = 256;
+				for (s32 a = 0; a <= maxValue; ++a)
+				{
+					for (s32 b = 0; b <= maxValue; ++b)
+					{
+						const s32 error = std::abs((2 * expand(a) + expand(b)) / 3 - value);
+						if (error < bestError)
+						{
+							bestError = error;
+							table[value] = { u8(a), u8(b) };
+						}
+					}
+				}
+			}
+		}
+	};
+
+	static const SolidBC1Table& GetSolidBC1Table()
+	{
+		static const SolidBC1Table table{};
+		return table;
+	}
+
+	static bool IsSolid(const u8* texels, s32 count)
+	{
+		for (s32 i = 1; i < count; ++i)
+		{
+			if (std::memcmp(texels, texels + i * 4, 4) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Texels with alpha 0 are unused atlas space, opaque encodings can give them any color. 'slots' maps the kept texels back to the block.
+	static s32 GatherUsedTexels(const u8* texels, u8* used, s32* slots)
+	{
+		s32 count = 0;
+		for (s32 i = 0; i < BLOCK_TEXELS; ++i)
+		{
+			if (texels[i * 4 + 3] != 0)
+			{
+				std::memcpy(used + count * 4, texels + i * 4, 4);
+				slots[count++] = i;
+			}
+		}
+
+		// Fully unused blocks keep their texels as they are.
+		if (count == 0)
+		{
+			std::memcpy(used, texels, BLOCK_TEXELS * 4);
+			for (s32 i = 0; i < BLOCK_TEXELS; ++i)
+			{
+				slots[i] = i;
+			}
+			count = BLOCK_TEXELS;
+		}
+
+		return count;
+	}
+
+	// Principal axis of the texels colors (first 'channels' channels), endpoints are the extremes of the texels projected on it.
+	static void GetAxisEndpoints(const u8* texels, s32 count, s32 channels, f32* low, f32* high)
+	{
+		f32 mean[4]{};
+		for (s32 i = 0; i < count; ++i)
+		{
+			for (s32 c = 0; c < channels; ++c)
+			{
+				mean[c] += texels[i * 4 + c];
+			}
+		}
+		for (s32 c = 0; c < channels; ++c)
+		{
+			mean[c] /= count;
+		}
+
+		f32 covariance[4][4]{};
+		for (s32 i = 0; i < count; ++i)
+		{
+			for (s32 a = 0; a < channels; ++a)
+			{
+				for (s32 b = a; b < channels; ++b)
+				{
+					covariance[a][b] += (texels[i * 4 + a] - mean[a]) * (texels[i * 4 + b] - mean[b]);
+				}
+			}
+		}
+		for (s32 a = 0; a < channels; ++a)
+		{
+			for (s32 b = 0; b < a; ++b)
+			{
+				covariance[a][b] = covariance[b][a];
+			}
+		}
+
+		// Power iteration, starting from the channel with the biggest variance.
+		f32 axis[4]{};
+		s32 start = 0;
+		for (s32 c = 1; c < channels; ++c)
+		{
+			start = covariance[c][c] > covariance[start][start] ? c : start;
+		}
+		axis[start] = 1.0f;
+
+		for (s32 iteration = 0; iteration < 8; ++iteration)
+		{
+			f32 next[4]{};
+			f32 length = 0.0f;
+			for (s32 a = 0; a < channels; ++a)
+			{
+				for (s32 b = 0; b < channels; ++b)
+				{
+					next[a] += covariance[a][b] * axis[b];
+				}
+				length = std::max(length, std::abs(next[a]));
+			}
+
+			if (length <= 0.0f)
+			{
+				break;
+			}
+
+			for (s32 c = 0; c < channels; ++c)
+			{
+				axis[c] = next[c] / length;
+			}
+		}
+
+		f32 minT = 0.0f, maxT = 0.0f;
+		for (s32 i = 0; i < count; ++i)
+		{
+			f32 t = 0.0f;
+			for (s32 c = 0; c < channels; ++c)
+			{
+				t += (texels[i * 4 + c] - mean[c]) * axis[c];
+			}
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		f32 axisLength2 = 0.0f;
+		for (s32 c = 0; c < channels; ++c)
+		{
+			axisLength2 += axis[c] * axis[c];
+		}
+		axisLength2 = std::max(axisLength2, 1e-8f);
+
+		for (s32 c = 0; c < channels; ++c)
+		{
+			low[c] = std::clamp(mean[c] + axis[c] * minT / axisLength2, 0.0f, 255.0f);
+			high[c] = std::clamp(mean[c] + axis[c] * maxT / axisLength2, 0.0f, 255.0f);
+		}
+	}
+
+	// Least squares endpoints for the given per texel weights of the high endpoint (0 - 1), false if the system is degenerated.
+	static bool SolveEndpoints(const u8* texels, s32 count, s32 channels, const f32* weights, f32* low, f32* high)
+	{
+		f32 aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		f32 ax[4]{}, bx[4]{};
+
+		for (s32 i = 0; i < count; ++i)
+		{
+			const f32 b = weights[i];
+			const f32 a = 1.0f - b;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+
+			for (s32 c = 0; c < channels; ++c)
+			{
+				ax[c] += a * texels[i * 4 + c];
+				bx[c] += b * texels[i * 4 + c];
+			}
+		}
+
+		const f32 determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		for (s32 c = 0; c < channels; ++c)
+		{
+			low[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+			high[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+		}
+		return true;
+	}
+
+	static inline u16 PackRGB565(s32 r, s32 g, s32 b)
+	{
+		return u16((r << 11) | (g << 5) | b);
+	}
+
+	struct BC1Candidate
+	{
+		u16 Color0 = 0;
+		u16 Color1 = 0;
+		u8 Indices[BLOCK_TEXELS]{};
+		s32 Error = 0;
+	};
+
+	// Index of every texel for the 565 endpoints, endpoints are ordered so the block stays in 4 colors mode.
+	static void FitBC1(const u8* texels, s32 count, const f32* low, const f32* high, BC1Candidate& candidate)
+	{
+		u16 color0 = PackRGB565(Quantize(s32(high[0] + 0.5f), 31), Quantize(s32(high[1] + 0.5f), 63), Quantize(s32(high[2] + 0.5f), 31));
+		u16 color1 = PackRGB565(Quantize(s32(low[0] + 0.5f), 31), Quantize(s32(low[1] + 0.5f), 63), Quantize(s32(low[2] + 0.5f), 31));
+		if (color0 < color1)
+		{
+			std::swap(color0, color1);
+		}
+
+		s32 palette[4][3];
+		const s32 e0[3] = { Expand5(color0 >> 11), Expand6((color0 >> 5) & 63), Expand5(color0 & 31) };
+		const s32 e1[3] = { Expand5(color1 >> 11), Expand6((color1 >> 5) & 63), Expand5(color1 & 31) };
+		for (s32 c = 0; c < 3; ++c)
+		{
+			palette[0][c] = e0[c];
+			palette[1][c] = e1[c];
+			palette[2][c] = (2 * e0[c] + e1[c]) / 3;
+			palette[3][c] = (e0[c] + 2 * e1[c]) / 3;
+		}
+
+		const s32 paletteSize = color0 == color1 ? 1 : 4;
+
+		candidate.Color0 = color0;
+		candidate.Color1 = color1;
+		candidate.Error = 0;
+		for (s32 i = 0; i < count; ++i)
+		{
+			const u8* texel = texels + i * 4;
+			s32 bestError = INT32_MAX;
+			for (s32 p = 0; p < paletteSize; ++p)
+			{
+				const s32 dr = texel[0] - palette[p][0], dg = texel[1] - palette[p][1], db = texel[2] - palette[p][2];
+				const s32 error = dr * dr + dg * dg + db * db;
+				if (error < bestError)
+				{
+					bestError = error;
+					candidate.Indices[i] = u8(p);
+				}
+			}
+			candidate.Error += bestError;
+		}
+	}
+
+	void BlockCompressor::EncodeBC1Block(const u8* texels, u8* block)
+	{
+		// BC1 is opaque, so unused texels are left out of the fit.
+		u8 used[BLOCK_TEXELS * 4];
+		s32 slots[BLOCK_TEXELS];
+		const s32 count = GatherUsedTexels(texels, used, slots);
+
+		BC1Candidate best{};
+
+		if (IsSolid(used, count))
+		{
+			const auto& table = GetSolidBC1Table();
+			const auto& r = table.Match5[used[0]];
+			const auto& g = table.Match6[used[1]];
+			const auto& b = table.Match5[used[2]];
+
+			best.Color0 = PackRGB565(r[0], g[0], b[0]);
+			best.Color1 = PackRGB565(r[1], g[1], b[1]);
+
+			// Texels sit at 2/3 of color0, or 2/3 of color1 (index 3) once swapped to keep 4 colors mode.
+			u8 index = 2;
+			if (best.Color0 < best.Color1)
+			{
+				std::swap(best.Color0, best.Color1);
+				index = 3;
+			}
+			else if (best.Color0 == best.Color1)
+			{
+				index = 0;
+			}
+			std::fill(best.Indices, best.Indices + count, index);
+		}
+		else
+		{
+			f32 low[4], high[4];
+			GetAxisEndpoints(used, count, 3, low, high);
+			FitBC1(used, count, low, high, best);
+
+			// One least squares refinement with the fitted indices.
+			static constexpr f32 weightOfColor1[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+			f32 weights[BLOCK_TEXELS];
+			for (s32 i = 0; i < count; ++i)
+			{
+				weights[i] = weightOfColor1[best.Indices[i]];
+			}
+
+			// Solved as (color0 = low, color1 = high) since weights are of color1.
+			if (best.Error > 0 && SolveEndpoints(used, count, 3, weights, high, low))
+			{
+				BC1Candidate refined{};
+				FitBC1(used, count, low, high, refined);
+				if (refined.Error < best.Error)
+				{
+					best = refined;
+				}
+			}
+		}
+
+		u32 indices = 0;
+		for (s32 i = 0; i < count; ++i)
+		{
+			indices |= u32(best.Indices[i]) << (slots[i] * 2);
+		}
+
+		block[0] = u8(best.Color0);
+		block[1] = u8(best.Color0 >> 8);
+		block[2] = u8(best.Color1);
+		block[3] = u8(best.Color1 >> 8);
+		block[4] = u8(indices);
+		block[5] = u8(indices >> 8);
+		block[6] = u8(indices >> 16);
+		block[7] = u8(indices >> 24);
+	}
+
+	// BC7 two subsets partitions, bit i is the subset of texel i, and the texel holding the implicit index bit of subset 1.
+	static constexpr u16 BC7_PARTITIONS2[64] =
+	{
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+		0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+		0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+		0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+		0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+	};
+
+	static constexpr u8 BC7_ANCHORS2[64] =
+	{
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+		15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+		6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+	};
+
+	// Mode 6 index used by solid blocks, stored with 3 bits so it must be below 8.
+	static constexpr s32 BC7_SOLID_INDEX = 7;
+
+	// Mode 6 endpoints (7 bits) hitting every 8 bits value at 'BC7_SOLID_INDEX', for every p-bit pair.
+	struct SolidBC7Table
+	{
+		std::array<std::array<std::array<u8, 2>, 256>, 4> Match{};
+		std::array<std::array<u8, 256>, 4> Error{};
+
+		SolidBC7Table()
+		{
+			const s32 weight = BC7_WEIGHTS4[BC7_SOLID_INDEX];
+
+			for (s32 pbits = 0; pbits < 4; ++pbits)
+			{
+				Error[pbits].fill(255);
+
+				for (s32 q0 = 0; q0 < 128; ++q0)
+				{
+					for (s32 q1 = 0; q1 < 128; ++q1)
+					{
+						const s32 e0 = (q0 << 1) | (pbits & 1);
+						const s32 e1 = (q1 << 1) | (pbits >> 1);
+						const s32 value = ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+
+						Match[pbits][value] = { u8(q0), u8(q1) };
+						Error[pbits][value] = 0;
+					}
+				}
+
+				// Values no pair hits use the closest one that is hit.
+				const auto hits = Error[pbits];
+				for (s32 value = 0; value < 256; ++value)
+				{
+					for (s32 distance = 1; hits[value] != 0 && Error[pbits][value] == 255 && distance < 256; ++distance)
+					{
+						for (const s32 other : { value - distance, value + distance })
+						{
+							if (other >= 0 && other < 256 && hits[other] == 0 && Error[pbits][value] == 255)
+							{
+								Match[pbits][value] = Match[pbits][other];
+								Error[pbits][value] = u8(distance);
+							}
+						}
+					}
+				}
+			}
+		}
+	};
+
+	static const SolidBC7Table& GetSolidBC7Table()
+	{
+		static const SolidBC7Table table{};
+		return table;
+	}
+
+	struct BC7Subset
+	{
+		u8 Endpoints[2][4]{}; // 7 bits
+		u8 PBits[2]{};
+		u8 Indices[BLOCK_TEXELS]{};
+		s32 Error = INT32_MAX;
+	};
+
+	// Quantizes the endpoints with their p-bits and indexes the texels, indices come from the projection on the endpoints line and its neighbors.
+	static void FitBC7Subset(const u8* texels, s32 count, s32 channels, const s32* weights, s32 weightCount, const f32* low, const f32* high, BC7Subset& best)
+	{
+		// Every endpoint takes the p-bit that rounds it best, trying the other pairs rarely wins.
+		BC7Subset candidate{};
+		s32 e[2][4]{};
+		for (s32 end = 0; end < 2; ++end)
+		{
+			const f32* values = end == 0 ? low : high;
+
+			f32 bestRounding = 1e30f;
+			for (s32 p = 0; p < 2; ++p)
+			{
+				s32 quantized[4]{};
+				f32 rounding = 0.0f;
+				for (s32 c = 0; c < channels; ++c)
+				{
+					quantized[c] = std::clamp(s32(std::lround((values[c] - p) * 0.5f)), 0, 127);
+					const f32 d = values[c] - f32((quantized[c] << 1) | p);
+					rounding += d * d;
+				}
+
+				if (rounding < bestRounding)
+				{
+					bestRounding = rounding;
+					candidate.PBits[end] = u8(p);
+					for (s32 c = 0; c < channels; ++c)
+					{
+						candidate.Endpoints[end][c] = u8(quantized[c]);
+						e[end][c] = (quantized[c] << 1) | p;
+					}
+				}
+			}
+		}
+
+		s32 palette[16][4];
+		for (s32 w = 0; w < weightCount; ++w)
+		{
+			for (s32 c = 0; c < channels; ++c)
+			{
+				palette[w][c] = ((64 - weights[w]) * e[0][c] + weights[w] * e[1][c] + 32) >> 6;
+			}
+		}
+
+		s32 axis[4]{};
+		s32 axisLength2 = 0;
+		for (s32 c = 0; c < channels; ++c)
+		{
+			axis[c] = e[1][c] - e[0][c];
+			axisLength2 += axis[c] * axis[c];
+		}
+
+		candidate.Error = 0;
+		for (s32 i = 0; i < count; ++i)
+		{
+			const u8* texel = texels + i * 4;
+
+			s32 guess = 0;
+			if (axisLength2 > 0)
+			{
+				s32 dot = 0;
+				for (s32 c = 0; c < channels; ++c)
+				{
+					dot += (texel[c] - e[0][c]) * axis[c];
+				}
+				guess = std::clamp(s32(std::lround(f32(dot) * (weightCount - 1) / axisLength2)), 0, weightCount - 1);
+			}
+
+			s32 bestError = INT32_MAX;
+			for (s32 w = std::max(0, guess - 1); w <= std::min(weightCount - 1, guess + 1); ++w)
+			{
+				s32 error = 0;
+				for (s32 c = 0; c < channels; ++c)
+				{
+					const s32 d = texel[c] - palette[w][c];
+					error += d * d;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					candidate.Indices[i] = u8(w);
+				}
+			}
+			candidate.Error += bestError;
+		}
+
+		if (candidate.Error < best.Error)
+		{
+			best = candidate;
+		}
+	}
+
+	// Principal axis endpoints, then one least squares refinement with the fitted indices.
+	static BC7Subset EncodeBC7Subset(const u8* texels, s32 count, s32 channels, const s32* weights, s32 weightCount)
+	{
+		f32 low[4], high[4];
+		GetAxisEndpoints(texels, count, channels, low, high);
+
+		BC7Subset best{};
+		FitBC7Subset(texels, count, channels, weights, weightCount, low, high, best);
+
+		if (best.Error > 0)
+		{
+			f32 fitWeights[BLOCK_TEXELS];
+			for (s32 i = 0; i < count; ++i)
+			{
+				fitWeights[i] = weights[best.Indices[i]] / 64.0f;
+			}
+
+			if (SolveEndpoints(texels, count, channels, fitWeights, low, high))
+			{
+				FitBC7Subset(texels, count, channels, weights, weightCount, low, high, best);
+			}
+		}
+
+		return best;
+	}
+
+	// Stored index bits have their msb implicit (0) at anchor texels, flip the subset when its anchor index has it set.
+	static void FixAnchor(BC7Subset& subset, s32 anchor, s32 weightCount)
+	{
+		if (subset.Indices[anchor] < weightCount / 2)
+		{
+			return;
+		}
+
+		std::swap(subset.Endpoints[0], subset.Endpoints[1]);
+		std::swap(subset.PBits[0], subset.PBits[1]);
+		for (auto& index : subset.Indices)
+		{
+			index = u8(weightCount - 1 - index);
+		}
+	}
+
+	// Writes 'count' bits of 'value' at 'offset' of a little endian 128 bits block.
+	static void PutBits(u8* block, s32& offset, u32 value, s32 count)
+	{
+		for (s32 i = 0; i < count; ++i, ++offset)
+		{
+			block[offset >> 3] |= u8(((value >> i) & 1) << (offset & 7));
+		}
+	}
+
+	static void WriteBC7Mode6(const BC7Subset& subset, u8* block)
+	{
+		std::memset(block, 0, 16);
+		s32 offset = 0;
+		PutBits(block, offset, 1u << 6, 7);
+
+		for (s32 c = 0; c < 4; ++c)
+		{
+			PutBits(block, offset, subset.Endpoints[0][c], 7);
+			PutBits(block, offset, subset.Endpoints[1][c], 7);
+		}
+
+		PutBits(block, offset, subset.PBits[0], 1);
+		PutBits(block, offset, subset.PBits[1], 1);
+
+		for (s32 i = 0; i < BLOCK_TEXELS; ++i)
+		{
+			PutBits(block, offset, subset.Indices[i], i == 0 ? 3 : 4);
+		}
+	}
+
+	// Scatter of the texels off their principal axis, what a line per subset can't represent.
+	static f32 GetLineResidual(const s32* moments, s32 count)
+	{
+		if (count < 2)
+		{
+			return 0.0f;
+		}
+
+		// moments: r, g, b sums, then rr, rg, rb, gg, gb, bb products.
+		const f32 inverseCount = 1.0f / count;
+		const f32 rr = moments[3] - moments[0] * moments[0] * inverseCount;
+		const f32 rg = moments[4] - moments[0] * moments[1] * inverseCount;
+		const f32 rb = moments[5] - moments[0] * moments[2] * inverseCount;
+		const f32 gg = moments[6] - moments[1] * moments[1] * inverseCount;
+		const f32 gb = moments[7] - moments[1] * moments[2] * inverseCount;
+		const f32 bb = moments[8] - moments[2] * moments[2] * inverseCount;
+
+		// A few power iterations and the Rayleigh quotient give the biggest eigenvalue closely enough to rank partitions.
+		f32 x = 1.0f, y = 1.0f, z = 1.0f;
+		for (s32 iteration = 0; iteration < 3; ++iteration)
+		{
+			const f32 nx = rr * x + rg * y + rb * z;
+			const f32 ny = rg * x + gg * y + gb * z;
+			const f32 nz = rb * x + gb * y + bb * z;
+
+			const f32 scale = std::max({ std::abs(nx), std::abs(ny), std::abs(nz) });
+			if (scale <= 0.0f)
+			{
+				return 0.0f;
+			}
+
+			x = nx / scale;
+			y = ny / scale;
+			z = nz / scale;
+		}
+
+		const f32 sx = rr * x + rg * y + rb * z;
+		const f32 sy = rg * x + gg * y + gb * z;
+		const f32 sz = rb * x + gb * y + bb * z;
+		const f32 eigenvalue = (x * sx + y * sy + z * sz) / (x * x + y * y + z * z);
+
+		return rr + gg + bb - eigenvalue;
+	}
+
+	// Mode 3: two subsets of opaque RGB with 8 bits endpoints (7 + p-bit) and 2 bits indices, the best few partitions are fully fitted.
+	// Only the 'count' used texels (see 'GatherUsedTexels') are fitted, returns their error.
+	static s32 EncodeBC7Mode3(const u8* used, const s32* slots, s32 count, u8* block)
+	{
+		static constexpr s32 CANDIDATES = 2;
+
+		// Color moments of every texel, a partition's subset 1 adds its texels and subset 0 is the rest.
+		s32 texelMoments[BLOCK_TEXELS][9]{};
+		s32 totalMoments[9]{};
+		for (s32 i = 0; i < count; ++i)
+		{
+			const u8* texel = used + i * 4;
+			s32* moments = texelMoments[slots[i]];
+			moments[0] = texel[0];
+			moments[1] = texel[1];
+			moments[2] = texel[2];
+			moments[3] = texel[0] * texel[0];
+			moments[4] = texel[0] * texel[1];
+			moments[5] = texel[0] * texel[2];
+			moments[6] = texel[1] * texel[1];
+			moments[7] = texel[1] * texel[2];
+			moments[8] = texel[2] * texel[2];
+
+			for (s32 k = 0; k < 9; ++k)
+			{
+				totalMoments[k] += moments[k];
+			}
+		}
+
+		u16 usedMask = 0;
+		for (s32 i = 0; i < count; ++i)
+		{
+			usedMask |= u16(1u << slots[i]);
+		}
+
+		std::array<std::pair<f32, s32>, 64> ranking{};
+		for (s32 partition = 0; partition < 64; ++partition)
+		{
+			const u16 mask = BC7_PARTITIONS2[partition] & usedMask;
+
+			s32 moments[2][9]{};
+			for (s32 i = 0; i < BLOCK_TEXELS; ++i)
+			{
+				if ((mask >> i) & 1)
+				{
+					for (s32 k = 0; k < 9; ++k)
+					{
+						moments[1][k] += texelMoments[i][k];
+					}
+				}
+			}
+
+			for (s32 k = 0; k < 9; ++k)
+			{
+				moments[0][k] = totalMoments[k] - moments[1][k];
+			}
+
+			const s32 count1 = s32(std::bitset<16>(mask).count());
+			ranking[partition] = { GetLineResidual(moments[0], count - count1) + GetLineResidual(moments[1], count1), partition };
+		}
+
+		std::partial_sort(ranking.begin(), ranking.begin() + CANDIDATES, ranking.end());
+
+		s32 bestError = INT32_MAX;
+		s32 bestPartition = 0;
+		BC7Subset bestSubsets[2]{};
+		u8 indices[BLOCK_TEXELS]{};
+
+		for (s32 candidate = 0; candidate < CANDIDATES; ++candidate)
+		{
+			const s32 partition = ranking[candidate].second;
+
+			u8 subsetTexels[2][BLOCK_TEXELS * 4];
+			s32 subsetSlots[2][BLOCK_TEXELS];
+			s32 counts[2]{};
+			for (s32 i = 0; i < count; ++i)
+			{
+				const s32 subset = (BC7_PARTITIONS2[partition] >> slots[i]) & 1;
+				std::memcpy(subsetTexels[subset] + counts[subset] * 4, used + i * 4, 4);
+				subsetSlots[subset][counts[subset]++] = slots[i];
+			}
+
+			BC7Subset subsets[2]{};
+			for (s32 subset = 0; subset < 2; ++subset)
+			{
+				subsets[subset] = counts[subset] > 0 ? EncodeBC7Subset(subsetTexels[subset], counts[subset], 3, BC7_WEIGHTS2, 4) : BC7Subset{};
+				subsets[subset].Error = counts[subset] > 0 ? subsets[subset].Error : 0;
+			}
+
+			if (subsets[0].Error + subsets[1].Error < bestError)
+			{
+				bestError = subsets[0].Error + subsets[1].Error;
+				bestPartition = partition;
+				bestSubsets[0] = subsets[0];
+				bestSubsets[1] = subsets[1];
+
+				// Indices in block order, unused texels take index 0.
+				std::fill(indices, indices + BLOCK_TEXELS, u8(0));
+				for (s32 subset = 0; subset < 2; ++subset)
+				{
+					for (s32 i = 0; i < counts[subset]; ++i)
+					{
+						indices[subsetSlots[subset][i]] = subsets[subset].Indices[i];
+					}
+				}
+			}
+		}
+
+		// Stored index bits have their msb implicit (0) at anchor texels, flip the subsets whose anchor has it set.
+		const u16 partitionMask = BC7_PARTITIONS2[bestPartition];
+		for (s32 subset = 0; subset < 2; ++subset)
+		{
+			const s32 anchor = subset == 0 ? 0 : BC7_ANCHORS2[bestPartition];
+			if (indices[anchor] < 2)
+			{
+				continue;
+			}
+
+			std::swap(bestSubsets[subset].Endpoints[0], bestSubsets[subset].Endpoints[1]);
+			std::swap(bestSubsets[subset].PBits[0], bestSubsets[subset].PBits[1]);
+			for (s32 i = 0; i < count; ++i)
+			{
+				if (((partitionMask >> slots[i]) & 1) == subset)
+				{
+					indices[slots[i]] = u8(3 - indices[slots[i]]);
+				}
+			}
+		}
+
+		std::memset(block, 0, 16);
+		s32 offset = 0;
+		PutBits(block, offset, 1u << 3, 4);
+		PutBits(block, offset, u32(bestPartition), 6);
+
+		for (s32 c = 0; c < 3; ++c)
+		{
+			for (const auto& subset : bestSubsets)
+			{
+				PutBits(block, offset, subset.Endpoints[0][c], 7);
+				PutBits(block, offset, subset.Endpoints[1][c], 7);
+			}
+		}
+
+		for (const auto& subset : bestSubsets)
+		{
+			PutBits(block, offset, subset.PBits[0], 1);
+			PutBits(block, offset, subset.PBits[1], 1);
+		}
+
+		for (s32 i = 0; i < BLOCK_TEXELS; ++i)
+		{
+			const bool anchor = i == 0 || i == BC7_ANCHORS2[bestPartition];
+			PutBits(block, offset, indices[i], anchor ? 1 : 2);
+		}
+
+		return bestError;
+	}
+
+	void BlockCompressor::EncodeBC7Block(const u8* texels, u8* block)
+	{
+		if (IsSolid(texels, BLOCK_TEXELS))
+		{
+			const auto& table = GetSolidBC7Table();
+
+			s32 bestPBits = 0;
+			s32 bestError = INT32_MAX;
+			for (s32 pbits = 0; pbits < 4; ++pbits)
+			{
+				s32 error = 0;
+				for (s32 c = 0; c < 4; ++c)
+				{
+					error += table.Error[pbits][texels[c]];
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					bestPBits = pbits;
+				}
+			}
+
+			BC7Subset solid{};
+			solid.PBits[0] = u8(bestPBits & 1);
+			solid.PBits[1] = u8(bestPBits >> 1);
+			for (s32 c = 0; c < 4; ++c)
+			{
+				solid.Endpoints[0][c] = table.Match[bestPBits][texels[c]][0];
+				solid.Endpoints[1][c] = table.Match[bestPBits][texels[c]][1];
+			}
+			std::fill(solid.Indices, solid.Indices + BLOCK_TEXELS, u8(BC7_SOLID_INDEX));
+
+			WriteBC7Mode6(solid, block);
+			return;
+		}
+
+		BC7Subset subset = EncodeBC7Subset(texels, BLOCK_TEXELS, 4, BC7_WEIGHTS4, 16);
+		FixAnchor(subset, 0, 16);
+		WriteBC7Mode6(subset, block);
+
+		// Blocks with more colors than a line can hold (common at face edges) try two opaque subsets, unused texels become opaque.
+		static constexpr s32 MODE3_MIN_ERROR = 16 * 4;
+		if (subset.Error <= MODE3_MIN_ERROR)
+		{
+			return;
+		}
+
+		u8 used[BLOCK_TEXELS * 4];
+		s32 slots[BLOCK_TEXELS];
+		const s32 count = GatherUsedTexels(texels, used, slots);
+
+		for (s32 i = 0; i < count; ++i)
+		{
+			if (used[i * 4 + 3] != 255)
+			{
+				return;
+			}
+		}
+
+		u8 mode3[16];
+		if (EncodeBC7Mode3(used, slots, count, mode3) < subset.Error)
+		{
+			std::memcpy(block, mode3, 16);
+		}
+	}
+
+	size_t BlockCompressor::GetBlockBytes(TextureFormat format)
+	{
+		return format == TextureFormat::BC1 ? 8 : 16;
+	}
+
+	std::vector<u8> BlockCompressor::Compress(const u8* rgba, s32 width, s32 height, TextureFormat format)
+	{
+		const s32 blocksX = (width + 3) / 4;
+		const s32 blocksY = (height + 3) / 4;
+		const size_t blockBytes = GetBlockBytes(format);
+
+		std::vector<u8> blocks(size_t(blocksX) * blocksY * blockBytes);
+
+		ParallelFor(size_t(blocksY), 16, [&](size_t by)
+		{
+			u8 texels[BLOCK_TEXELS * 4];
+			for (s32 bx = 0; bx < blocksX; ++bx)
+			{
+				for (s32 y = 0; y < 4; ++y)
+				{
+					const s32 sy = std::min(s32(by) * 4 + y, height - 1);
+					for (s32 x = 0; x < 4; ++x)
+					{
+						const s32 sx = std::min(bx * 4 + x, width - 1);
+						std::memcpy(texels + (y * 4 + x) * 4, rgba + (size_t(sy) * width + sx) * 4, 4);
+					}
+				}
+
+				u8* block = blocks.data() + (by * blocksX + bx) * blockBytes;
+				if (format == TextureFormat::BC1)
+				{
+					EncodeBC1Block(texels, block);
+				}
+				else
+				{
+					EncodeBC7Block(texels, block);
+				}
+			}
+		});
+
+		return blocks;
+	}
+}
@@ -0,0 +1,182 @@
+#include <Unvoxeller/KtxWriter.h>
+#include <Unvoxeller/BlockCompressor.h>
+#include <Unvoxeller/MipGenerator.h>
+#include <Unvoxeller/Log/Log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Unvoxeller
+{
+	// Vulkan formats, atlas colors come from the vox palette so they are sRGB like the pngs.
+	static constexpr u32 VK_FORMAT_BC1_RGB_SRGB_BLOCK = 132;
+	static constexpr u32 VK_FORMAT_BC7_SRGB_BLOCK = 146;
+
+	// Khronos data format descriptor values.
+	static constexpr u8 KHR_DF_MODEL_BC1A = 128;
+	static constexpr u8 KHR_DF_MODEL_BC7 = 135;
+	static constexpr u8 KHR_DF_PRIMARIES_BT709 = 1;
+	static constexpr u8 KHR_DF_TRANSFER_SRGB = 2;
+
+	struct MipLevel
+	{
+		std::vector<u8> Blocks;
+		size_t Offset = 0;
+	};
+
+	static void PutU32(std::vector<u8>& out, size_t offset, u32 value)
+	{
+		for (s32 i = 0; i < 4; ++i)
+		{
+			out[offset + i] = u8(value >> (i * 8));
+		}
+	}
+
+	static void PutU64(std::vector<u8>& out, size_t offset, u64 value)
+	{
+		for (s32 i = 0; i < 8; ++i)
+		{
+			out[offset + i] = u8(value >> (i * 8));
+		}
+	}
+
+	bool KtxWriter::Encode(const u8* rgba, s32 width, s32 height, const std::vector<std::vector<u8>>& mipLevels, TextureFormat format, bool mips, std::vector<u8>& ktx)
+	{
+		if (!rgba || width <= 0 || height <= 0 || !IsBlockCompressed(format))
+		{
+			return false;
+		}
+
+		const bool bc1 = format == TextureFormat::BC1;
+		const size_t blockBytes = BlockCompressor::GetBlockBytes(format);
+
+		const s32 levelCount = mips ? s32(std::log2(std::max(width, height))) + 1 : 1;
+		std::vector<MipLevel> levels(levelCount);
+
+		std::vector<u8> downsampled{};
+		const u8* image = rgba;
+		s32 levelWidth = width;
+		s32 levelHeight = height;
+		for (s32 level = 0; level < levelCount; ++level)
+		{
+			if (level > 0)
+			{
+				if (level <= s32(mipLevels.size()))
+				{
+					image = mipLevels[level - 1].data();
+				}
+				else
+				{
+					downsampled = MipGenerator::Downsample(image, levelWidth, levelHeight);
+					image = downsampled.data();
+				}
+
+				levelWidth = MipGenerator::GetMipSize(levelWidth);
+				levelHeight = MipGenerator::GetMipSize(levelHeight);
+			}
+
+			levels[level].Blocks = BlockCompressor::Compress(image, levelWidth, levelHeight, format);
+		}
+
+		// Header, index and level index.
+		const size_t levelIndexOffset = 80;
+		const size_t dfdOffset = levelIndexOffset + 24 * levelCount;
+
+		// Basic data format descriptor with a single sample covering the whole block.
+		const u32 dfdBlockSize = 24 + 16;
+		const u32 dfdSize = 4 + dfdBlockSize;
+
+		// Key/value data, just who wrote the file.
+		const char writerKey[] = "KTXwriter";
+		const char writerValue[] = "Unvoxeller";
+		const u32 kvdEntrySize = u32(sizeof(writerKey) + sizeof(writerValue));
+		const size_t kvdOffset = dfdOffset + dfdSize;
+		const u32 kvdSize = (4 + kvdEntrySize + 3) & ~3u;
+
+		// Levels go from the smallest mip to the biggest one, aligned to the block size.
+		size_t offset = kvdOffset + kvdSize;
+		for (s32 level = levelCount - 1; level >= 0; --level)
+		{
+			offset = (offset + blockBytes - 1) / blockBytes * blockBytes;
+			levels[level].Offset = offset;
+			offset += levels[level].Blocks.size();
+		}
+
+		ktx.assign(offset, 0);
+
+		const u8 identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+		std::memcpy(ktx.data(), identifier, sizeof(identifier));
+
+		PutU32(ktx, 12, bc1 ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC7_SRGB_BLOCK);
+		PutU32(ktx, 16, 1);                   // typeSize
+		PutU32(ktx, 20, u32(width));
+		PutU32(ktx, 24, u32(height));
+		PutU32(ktx, 28, 0);                   // pixelDepth
+		PutU32(ktx, 32, 0);                   // layerCount
+		PutU32(ktx, 36, 1);                   // faceCount
+		PutU32(ktx, 40, u32(levelCount));
+		PutU32(ktx, 44, 0);                   // supercompressionScheme
+
+		PutU32(ktx, 48, u32(dfdOffset));
+		PutU32(ktx, 52, dfdSize);
+		PutU32(ktx, 56, u32(kvdOffset));
+		PutU32(ktx, 60, kvdSize);
+		PutU64(ktx, 64, 0);                   // sgdByteOffset
+		PutU64(ktx, 72, 0);                   // sgdByteLength
+
+		for (s32 level = 0; level < levelCount; ++level)
+		{
+			const size_t entry = levelIndexOffset + 24 * level;
+			PutU64(ktx, entry, levels[level].Offset);
+			PutU64(ktx, entry + 8, levels[level].Blocks.size());
+			PutU64(ktx, entry + 16, levels[level].Blocks.size());
+		}
+
+		PutU32(ktx, dfdOffset, dfdSize);
+		PutU32(ktx, dfdOffset + 4, 0);                                    // vendorId, descriptorType
+		PutU32(ktx, dfdOffset + 8, 2u | (dfdBlockSize << 16));            // versionNumber, descriptorBlockSize
+		ktx[dfdOffset + 12] = bc1 ? KHR_DF_MODEL_BC1A : KHR_DF_MODEL_BC7;
+		ktx[dfdOffset + 13] = KHR_DF_PRIMARIES_BT709;
+		ktx[dfdOffset + 14] = KHR_DF_TRANSFER_SRGB;
+		ktx[dfdOffset + 15] = 0;                                          // flags, straight alpha
+		ktx[dfdOffset + 16] = 3;                                          // texelBlockDimension - 1
+		ktx[dfdOffset + 17] = 3;
+		ktx[dfdOffset + 20] = u8(blockBytes);                             // bytesPlane0
+
+		// Sample: bit offset 0, bit length - 1, channel 0 (BC1 color / BC7 data), lower 0, upper 0xFFFFFFFF.
+		PutU32(ktx, dfdOffset + 28, u32(blockBytes * 8 - 1) << 16);
+		PutU32(ktx, dfdOffset + 36, 0);
+		PutU32(ktx, dfdOffset + 40, 0xFFFFFFFFu);
+
+		PutU32(ktx, kvdOffset, kvdEntrySize);
+		std::memcpy(ktx.data() + kvdOffset + 4, writerKey, sizeof(writerKey));
+		std::memcpy(ktx.data() + kvdOffset + 4 + sizeof(writerKey), writerValue, sizeof(writerValue));
+
+		for (const auto& level : levels)
+		{
+			std::memcpy(ktx.data() + level.Offset, level.Blocks.data(), level.Blocks.size());
+		}
+
+		return true;
+	}
+
+	bool KtxWriter::Write(const std::string& path, const u8* rgba, s32 width, s32 height, const std::vector<std::vector<u8>>& mipLevels, TextureFormat format, bool mips)
+	{
+		std::vector<u8> ktx{};
+		if (!Encode(rgba, width, height, mipLevels, format, mips, ktx))
+		{
+			return false;
+		}
+
+		std::ofstream imageStream(path, std::ios::out | std::ios::binary);
+		if (!imageStream)
+		{
+			LOG_ERROR("Can't open: {0}", path);
+			return false;
+		}
+
+		imageStream.write(reinterpret_cast<const char*>(ktx.data()), std::streamsize(ktx.size()));
+		return bool(imageStream);
+	}
+}
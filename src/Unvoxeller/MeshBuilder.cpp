@@ -1,111 +1,297 @@
 #include <Unvoxeller/MeshBuilder.h>
+#include <Unvoxeller/Log/Log.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNVOXELLER_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace Unvoxeller
 {
+	static constexpr s32 ORIENTATION_BITS = 3;
+
+	// Bits to store values from 0 to 'maxValue'.
+	static s32 BitsFor(u32 maxValue)
+	{
+		s32 bits = 0;
+		while (bits < 32 && (u64(1) << bits) <= maxValue)
+		{
+			++bits;
+		}
+		return bits;
+	}
+
+	// Open addressing (linear probing) map from packed vertex keys to vertex indices, sized once for every corner of the mesh.
+	class VertexWeldTable
+	{
+	public:
+		explicit VertexWeldTable(size_t maxKeys)
+		{
+			size_t capacity = 16;
+			while (capacity < maxKeys * 2)
+			{
+				capacity <<= 1;
+			}
+
+			_slots.resize(maxKeys > 0 ? capacity : 0, { 0, EMPTY });
+			_mask = capacity - 1;
+		}
+
+		// Index stored for 'key', 'index' is stored and returned if the key isn't there yet.
+		u32 FindOrInsert(u64 key, u32 index)
+		{
+			size_t slot = size_t((key * 0x9E3779B97F4A7C15ull) >> 32) & _mask;
+
+			while (_slots[slot].Index != EMPTY)
+			{
+				if (_slots[slot].Key == key)
+				{
+					return _slots[slot].Index;
+				}
+
+				slot = (slot + 1) & _mask;
+			}
+
+			_slots[slot] = { key, index };
+			return index;
+		}
+
+	private:
+		static constexpr u32 EMPTY = ~0u;
+
+		struct Slot
+		{
+			u64 Key;
+			u32 Index;
+		};
+
+		std::vector<Slot> _slots;
+		size_t _mask = 0;
+	};
+
+	// One output axis of the vertex transform: '((source - Pivot) * Sign + Translation) * Mirror'.
+	// Rotations that only swap and flip axes (every MagicaVoxel rotation) reduce to one source axis per output axis.
+	struct AxisTransform
+	{
+		const s32* Source;
+		f32 Pivot;
+		f32 Sign;
+		f32 Translation;
+		f32 Mirror;
+	};
+
+	// Row 'i' of 'rotation' as its only non zero column and sign, false if it isn't a signed permutation.
+	static bool DecodeSignedPermutation(const glm::mat3& rotation, s32 (&axis)[3], f32 (&sign)[3])
+	{
+		for (s32 row = 0; row < 3; ++row)
+		{
+			s32 found = 0;
+			for (s32 col = 0; col < 3; ++col)
+			{
+				const f32 m = rotation[col][row];
+				if (m == 1.0f || m == -1.0f)
+				{
+					axis[row] = col;
+					sign[row] = m;
+					++found;
+				}
+				else if (m != 0.0f)
+				{
+					return false;
+				}
+			}
+
+			if (found != 1)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static void TransformPositions(const AxisTransform (&axes)[3], size_t first, size_t count, glm::vec3* out)
+	{
+		for (size_t i = first; i < count; ++i)
+		{
+			for (s32 a = 0; a < 3; ++a)
+			{
+				out[i][a] = ((f32(axes[a].Source[i]) - axes[a].Pivot) * axes[a].Sign + axes[a].Translation) * axes[a].Mirror;
+			}
+		}
+	}
+
+#ifdef UNVOXELLER_SSE2
+	static inline __m128 TransformAxis(const AxisTransform& axis, size_t i)
+	{
+		const __m128 source = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(axis.Source + i)));
+		const __m128 moved = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(source, _mm_set1_ps(axis.Pivot)), _mm_set1_ps(axis.Sign)), _mm_set1_ps(axis.Translation));
+		return _mm_mul_ps(moved, _mm_set1_ps(axis.Mirror));
+	}
+
+	// 4 vertices per iteration, transposed from x/y/z registers into 3 registers of packed vec3s. Returns how many were done.
+	static size_t TransformPositionsSSE2(const AxisTransform (&axes)[3], size_t count, glm::vec3* out)
+	{
+		static_assert(sizeof(glm::vec3) == sizeof(f32) * 3, "packed vec3 expected");
+
+		f32* dst = &out[0].x;
+		const size_t batched = count & ~size_t(3);
+
+		for (size_t i = 0; i < batched; i += 4)
+		{
+			const __m128 x = TransformAxis(axes[0], i);
+			const __m128 y = TransformAxis(axes[1], i);
+			const __m128 z = TransformAxis(axes[2], i);
+
+			const __m128 xy01 = _mm_unpacklo_ps(x, y);
+			const __m128 xy23 = _mm_unpackhi_ps(x, y);
+			const __m128 z0x1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+			const __m128 y1z1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+			const __m128 z2z3 = _mm_shuffle_ps(z, xy23, _MM_SHUFFLE(3, 2, 3, 2));
+
+			_mm_storeu_ps(dst + i * 3, _mm_shuffle_ps(xy01, z0x1, _MM_SHUFFLE(2, 0, 1, 0)));
+			_mm_storeu_ps(dst + i * 3 + 4, _mm_shuffle_ps(y1z1, xy23, _MM_SHUFFLE(1, 0, 2, 0)));
+			_mm_storeu_ps(dst + i * 3 + 8, _mm_shuffle_ps(z2z3, z2z3, _MM_SHUFFLE(1, 3, 2, 0)));
+		}
+
+		return batched;
+	}
+#endif
+
+	// Unit normal of a face orientation, in voxel space.
+	static glm::vec3 GetOrientationNormal(Orientation orientation)
+	{
+		switch (orientation)
+		{
+		case Orientation::PosX: return { +1, 0, 0 };
+		case Orientation::NegX: return { -1, 0, 0 };
+		case Orientation::PosY: return { 0, +1, 0 };
+		case Orientation::NegY: return { 0, -1, 0 };
+		case Orientation::PosZ: return { 0, 0, +1 };
+		default: return { 0, 0, -1 };
+		}
+	}
+
     // Build the actual geometry (vertices and indices) for a mesh from the FaceRect list and a given texture atlas configuration.
 std::shared_ptr<UnvoxMesh> MeshBuilder::BuildMeshFromFaces(
         const std::vector<FaceRect>& faces,
         int texWidth, int texHeight,
-        bool flatShading,
         const std::vector<color>& palette,
         const bbox& box,
 		const vox_size& size,
         const glm::mat3& rotation,
-        const glm::vec3& translation
+        const glm::vec3& translation,
+        bool vertexColors,
+        bool paletteIndices,
+        f32 uvInset,
+        bool indices16,
+        s32 voxelScale
 )
 {
 	std::shared_ptr<UnvoxMesh> mesh = std::make_shared<UnvoxMesh>();
 
-	// 1) Build raw voxel-space verts & indices
-	struct Vertex 
-	{
-		float px, py, pz;
-		float nx, ny, nz;
-		float u, v;
-		uint32_t colorIndex;
-	};
+	// Without a texture (vertex colors, or textures not generated) faces have no atlas location and the mesh no uvs
+	const bool textured = !vertexColors && texWidth > 0 && texHeight > 0;
 
-	std::vector<Vertex>       verts;
-	std::vector<unsigned int> indices;
-	verts.reserve(faces.size() * 4);
+	// 1) Build raw voxel-space verts & indices, positions are kept per axis (SoA) for the batched transform,
+	// normals come from the orientation and uvs go straight to the mesh.
+	std::vector<s32> posX, posY, posZ;
+	std::vector<Orientation> orientations;
+	std::vector<u8> colorIndices;
+	std::vector<u32> indices;
+
+	for (auto* axis : { &posX, &posY, &posZ })
+	{
+		axis->reserve(faces.size() * 4);
+	}
+	orientations.reserve(faces.size() * 4);
 	indices.reserve(faces.size() * 6);
 
-	// New key that includes pos, normal, uv, and colorIndex
-	struct VertKey 
+	if (vertexColors)
 	{
-		int px_i, py_i, pz_i;
-		int nx_i, ny_i, nz_i;
-		int u_i, v_i;
-		uint32_t colorIndex;
-		bool operator==(VertKey const& o) const 
-		{
-			return px_i == o.px_i && py_i == o.py_i && pz_i == o.pz_i
-				&& nx_i == o.nx_i && ny_i == o.ny_i && nz_i == o.nz_i
-				&& u_i == o.u_i && v_i == o.v_i
-				&& colorIndex == o.colorIndex;
-		}
-	};
+		colorIndices.reserve(faces.size() * 4);
+	}
+	else if (textured)
+	{
+		mesh->UVs.reserve(faces.size() * 4);
+	}
 
-	struct VertKeyHash 
+	// Vertices are welded by an exact packed key: integer corner, orientation, and the atlas corner in quarter texels
+	// (uvs are texel edges, inset a bit to either side, or texel centers) or, with vertex colors, the color index.
+	s32 maxCoord = 0;
+	for (const auto& face : faces)
 	{
-		size_t operator()(VertKey const& k) const noexcept 
-		{
-			// combine all 8 ints + colorIndex
-			size_t h = 146527; // random seed
-			auto mix = [&](size_t v) { h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
-			mix(std::hash<int>()(k.px_i));
-			mix(std::hash<int>()(k.py_i));
-			mix(std::hash<int>()(k.pz_i));
-			mix(std::hash<int>()(k.nx_i));
-			mix(std::hash<int>()(k.ny_i));
-			mix(std::hash<int>()(k.nz_i));
-			mix(std::hash<int>()(k.u_i));
-			mix(std::hash<int>()(k.v_i));
-			mix(std::hash<uint32_t>()(k.colorIndex));
-			return h;
-		}
-	};
+		maxCoord = std::max({ maxCoord, face.uMax, face.vMax, face.constantCoord });
+	}
 
-	std::unordered_map<VertKey, unsigned int, VertKeyHash> vertMap;
-	vertMap.reserve(faces.size() * 4);
+	const s32 posBits = BitsFor(u32(maxCoord));
+	const s32 uvBits = textured ? BitsFor(u32(std::max(texWidth, texHeight)) * 4) : 0;
+	const s32 colorBits = vertexColors ? 8 : 0;
+	const bool weld = posBits * 3 + ORIENTATION_BITS + uvBits * 2 + colorBits <= 64;
 
-	auto addVertex = [&](float vx, float vy, float vz,
-		float nx, float ny, float nz,
-		float u, float v,
-		uint32_t colorIndex) -> unsigned int
-		{
-			// quantize everything to integers so hashing is stable
-			VertKey key;
-			key.px_i = int(std::round(vx * 100.0f));
-			key.py_i = int(std::round(vy * 100.0f));
-			key.pz_i = int(std::round(vz * 100.0f));
+	if (!weld)
+	{
+		LOG_WARN("Mesh too big for the vertex weld key, coords: {0}, texture: ({1}, {2}), vertices won't be shared", maxCoord, texWidth, texHeight);
+	}
 
-			key.nx_i = int(std::round(nx * 1000.0f));
-			key.ny_i = int(std::round(ny * 1000.0f));
-			key.nz_i = int(std::round(nz * 1000.0f));
+	VertexWeldTable weldTable(weld ? faces.size() * 4 : 0);
 
-			key.u_i = int(std::round(u * texWidth * 100.0f));
-			key.v_i = int(std::round(v * texHeight * 100.0f));
+	auto addVertex = [&](s32 vx, s32 vy, s32 vz, Orientation orientation,
+		s32 hu, s32 hv, float u, float v,
+		u8 colorIndex) -> u32
+		{
+			const u32 idx = static_cast<u32>(posX.size());
 
-			key.colorIndex = colorIndex;
+			if (weld)
+			{
+				u64 key = vx;
+				key = (key << posBits) | u64(vy);
+				key = (key << posBits) | u64(vz);
+				key = (key << ORIENTATION_BITS) | u64(orientation);
+
+				if (vertexColors)
+				{
+					key = (key << colorBits) | colorIndex;
+				}
+				else if (textured)
+				{
+					assert(hu >= 0 && hv >= 0 && u64(hu) < (u64(1) << uvBits) && u64(hv) < (u64(1) << uvBits));
+					key = (key << uvBits) | u64(hu);
+					key = (key << uvBits) | u64(hv);
+				}
+
+				const u32 found = weldTable.FindOrInsert(key, idx);
+				if (found != idx)
+				{
+					return found;
+				}
+			}
 
-			// lookup/insert
-			if (auto it = vertMap.find(key); it != vertMap.end()) 
+			posX.push_back(vx);
+			posY.push_back(vy);
+			posZ.push_back(vz);
+			orientations.push_back(orientation);
+
+			if (vertexColors)
 			{
-				return it->second;
+				colorIndices.push_back(colorIndex);
 			}
-			else 
+			else if (textured)
 			{
-				unsigned int idx = (unsigned int)verts.size();
-				verts.push_back(Vertex{ vx,vy,vz, nx,ny,nz, u,v, colorIndex });
-				vertMap[key] = idx;
-				return idx;
+				mesh->UVs.push_back({ u, v });
 			}
+
+			return idx;
 		};
 
-	const float pixelW = 1.0f / float(texWidth),
-		pixelH = 1.0f / float(texHeight),
-		border = 1.0f;
+	// Inset uvs are a quarter texel step away from the edge in the weld key
+	const s32 insetSteps = uvInset > 0.0f ? 1 : 0;
+
+	const float pixelW = textured ? 1.0f / float(texWidth) : 0.0f,
+		pixelH = textured ? 1.0f / float(texHeight) : 0.0f;
 
 	// winding‐flip test unchanged
 	float det =
@@ -118,15 +304,30 @@ std::shared_ptr<UnvoxMesh> MeshBuilder::BuildMeshFromFaces(
 	// 2) Emit all faces
 	for (auto& face : faces) 
 	{
-		// atlas UVs
-		float u0 = (face.atlasX + border) * pixelW;
-		float v0 = 1.0f - (face.atlasY + border) * pixelH;
-		float u1 = (face.atlasX + border + face.w) * pixelW;
-		float v1 = 1.0f - (face.atlasY + border + face.h) * pixelH;
+		// atlas UVs, inset when faces have no border around them
+		float u0 = (face.atlasX + uvInset) * pixelW;
+		float v0 = 1.0f - (face.atlasY + uvInset) * pixelH;
+		float u1 = (face.atlasX + face.w - uvInset) * pixelW;
+		float v1 = 1.0f - (face.atlasY + face.h - uvInset) * pixelH;
+
+		// Same corners in quarter texels for the weld key
+		s32 hu0 = face.atlasX * 4 + insetSteps;
+		s32 hv0 = face.atlasY * 4 + insetSteps;
+		s32 hu1 = (face.atlasX + face.w) * 4 - insetSteps;
+		s32 hv1 = (face.atlasY + face.h) * 4 - insetSteps;
+
+		// Single colored faces sample the center of their only texel
+		if (face.uniformColor)
+		{
+			u0 = u1 = (face.atlasX + 0.5f) * pixelW;
+			v0 = v1 = 1.0f - (face.atlasY + 0.5f) * pixelH;
+			hu0 = hu1 = face.atlasX * 4 + 2;
+			hv0 = hv1 = face.atlasY * 4 + 2;
+		}
 
 		// face normal + 4 corners
 		float nx = 0, ny = 0, nz = 0;
-		float x0, y0, z0, x1, y1, z1, x2, y2, z2, x3, y3, z3;
+		s32 x0, y0, z0, x1, y1, z1, x2, y2, z2, x3, y3, z3;
 		switch (face.orientation) 
 		{
 		case Orientation::PosX:
@@ -139,7 +340,7 @@ std::shared_ptr<UnvoxMesh> MeshBuilder::BuildMeshFromFaces(
 		case Orientation::NegX:
 			nx = -1;
 			{
-				float f = face.constantCoord, zmin = face.uMin, zmax = face.uMax;
+				s32 f = face.constantCoord, zmin = face.uMin, zmax = face.uMax;
 				std::swap(zmin, zmax);
 				x0 = f; y0 = face.vMin; z0 = zmin;
 				x1 = f; y1 = face.vMax; z1 = zmin;
@@ -157,7 +358,7 @@ std::shared_ptr<UnvoxMesh> MeshBuilder::BuildMeshFromFaces(
 		case Orientation::NegY:
 			ny = -1;
 			{
-				float f = face.constantCoord, zmin = face.vMin, zmax = face.vMax;
+				s32 f = face.constantCoord, zmin = face.vMin, zmax = face.vMax;
 				std::swap(zmin, zmax);
 				x0 = face.uMin; y0 = f; z0 = zmin;
 				x1 = face.uMin; y1 = f; z1 = zmax;
@@ -175,7 +376,7 @@ std::shared_ptr<UnvoxMesh> MeshBuilder::BuildMeshFromFaces(
 		case Orientation::NegZ:
 			nz = -1;
 			{
-				float f = face.constantCoord, xmin = face.uMin, xmax = face.uMax;
+				s32 f = face.constantCoord, xmin = face.uMin, xmax = face.uMax;
 				std::swap(xmin, xmax);
 				x0 = xmin; y0 = face.vMin; z0 = f;
 				x1 = xmin; y1 = face.vMax; z1 = f;
@@ -188,102 +389,122 @@ std::shared_ptr<UnvoxMesh> MeshBuilder::BuildMeshFromFaces(
 		}
 
 		// add (and weld) the 4 verts
-		auto i0 = addVertex(x0, y0, z0, nx, ny, nz, u0, v0, face.colorIndex);
-		auto i1 = addVertex(x1, y1, z1, nx, ny, nz, u0, v1, face.colorIndex);
-		auto i2 = addVertex(x2, y2, z2, nx, ny, nz, u1, v1, face.colorIndex);
-		auto i3 = addVertex(x3, y3, z3, nx, ny, nz, u1, v0, face.colorIndex);
+		auto i0 = addVertex(x0, y0, z0, face.orientation, hu0, hv0, u0, v0, face.colorIndex);
+		auto i1 = addVertex(x1, y1, z1, face.orientation, hu0, hv1, u0, v1, face.colorIndex);
+		auto i2 = addVertex(x2, y2, z2, face.orientation, hu1, hv1, u1, v1, face.colorIndex);
+		auto i3 = addVertex(x3, y3, z3, face.orientation, hu1, hv0, u1, v0, face.colorIndex);
 
 		// winding test
-		const glm::vec3 P0{ x0,y0,z0 }, P1{ x1,y1,z1 }, P2{ x2,y2,z2 };
+		const glm::vec3 P0( x0,y0,z0 ), P1( x1,y1,z1 ), P2( x2,y2,z2 );
 		const glm::vec3 triN = cross(P1 - P0, P2 - P0);
 		const bool baseIsCCW = (dot(triN, glm::vec3{ nx,ny,nz }) > 0.0f);
 		const bool finalIsCCW = shouldInvert ? !baseIsCCW : baseIsCCW;
 
+		const size_t first = indices.size();
+		indices.resize(first + 6);
+		u32* tri = indices.data() + first;
+
 		if (finalIsCCW)
 		{
-			indices.insert(indices.end(), { i0,i1,i2,  i0,i2,i3 });
+			tri[0] = i0; tri[1] = i1; tri[2] = i2;
+			tri[3] = i0; tri[4] = i2; tri[5] = i3;
 		}
 		else 
 		{
-			indices.insert(indices.end(), { i0,i2,i1,  i0,i3,i2 });
+			tri[0] = i0; tri[1] = i2; tri[2] = i1;
+			tri[3] = i0; tri[4] = i3; tri[5] = i2;
 		}
 	}
 
-	// 3) If smooth shading, normalize summed normals
-	if (!flatShading) 
+	// Downsampled voxels span several source voxels, the uvs stay in atlas texels
+	if (voxelScale != 1)
 	{
-		for (auto& v : verts) 
+		for (auto* positions : { &posX, &posY, &posZ })
 		{
-			float L = std::sqrt(v.nx * v.nx + v.ny * v.ny + v.nz * v.nz);
-			if (L > 0) { v.nx /= L; v.ny /= L; v.nz /= L; }
+			for (s32& position : *positions)
+			{
+				position *= voxelScale;
+			}
 		}
 	}
 
-	mesh->Vertices.resize(verts.size());
-	mesh->Normals.resize(verts.size());
-	mesh->UVs.resize(verts.size());
+	// 3) Transform into the output space: recenter → rotate → swizzle into Assimp (Y⇄Z) → translate → un-mirror X.
+	// Face normals are unit axes and never get summed, so smooth shading has nothing to normalize.
+	const size_t vertexCount = posX.size();
+	mesh->Vertices.resize(vertexCount);
+	mesh->Normals.resize(vertexCount);
+
+	const glm::vec3 pivot{ size.x * 0.5f, size.y * 0.5f, size.z * 0.5f };
 
-	glm::vec3 pivot {
-    size.x * 0.5f,
-    size.y * 0.5f,
-    size.z * 0.5f
-};
+	// Output axes take rotated rows x, z, y
+	static constexpr s32 SWIZZLE[3] = { 0, 2, 1 };
+	const std::vector<s32>* sources[3] = { &posX, &posY, &posZ };
 
-	for (unsigned int i = 0; i < verts.size(); ++i) 
+	s32 rotationAxis[3]{};
+	f32 rotationSign[3]{};
+	if (DecodeSignedPermutation(rotation, rotationAxis, rotationSign))
 	{
-		// recenter → rotate → swizzle → translate → mirror (exactly as before)
-		float x = verts[i].px - pivot.x,
-			  y = verts[i].py - pivot.y,
-			  z = verts[i].pz - pivot.z;
-			  
-		float nx = verts[i].nx,
-			  ny = verts[i].ny,
-			  nz = verts[i].nz;
-
-		// apply rotation to pos & normal...
-		glm::vec3 v(x, y, z);
-		glm::vec3 n(nx, ny, nz);
-
-		glm::vec3 rotatedV = rotation * v;
-		glm::vec3 rotatedN = rotation * n;
-
-		x = rotatedV.x;
-		y = rotatedV.y;
-		z = rotatedV.z;
-
-		nx = rotatedN.x;
-		ny = rotatedN.y;
-		nz = rotatedN.z;
-
-		// swizzle into Assimp
-		glm::vec3 pos{ x, z, y };
-		glm::vec3 norm{ nx, nz, ny };
-
-		// translation w/ Y⇄Z swap, then un-mirror X
-		pos.x += translation.x; 
-		pos.y += translation.z; 
-		pos.z += translation.y;
-
-		pos.x = -pos.x;  
-		norm.x = -norm.x;
-
-		mesh->Vertices[i] = pos;
-		mesh->Normals[i] = norm;
-		mesh->UVs[i] = { verts[i].u, verts[i].v };
+		AxisTransform axes[3]{};
+		for (s32 a = 0; a < 3; ++a)
+		{
+			const s32 row = SWIZZLE[a];
+			const s32 source = rotationAxis[row];
+			axes[a] = { sources[source]->data(), pivot[source], rotationSign[row], translation[row], a == 0 ? -1.0f : 1.0f };
+		}
+
+		size_t done = 0;
+#ifdef UNVOXELLER_SSE2
+		done = TransformPositionsSSE2(axes, vertexCount, mesh->Vertices.data());
+#endif
+		TransformPositions(axes, done, vertexCount, mesh->Vertices.data());
+	}
+	else
+	{
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			const glm::vec3 rotated = rotation * (glm::vec3(posX[i], posY[i], posZ[i]) - pivot);
+			mesh->Vertices[i] = { -(rotated.x + translation.x), rotated.z + translation.z, rotated.y + translation.y };
+		}
 	}
 
-	mesh->Faces.resize(static_cast<u32>((indices.size() / 3)));
+	// Every vertex of an orientation shares its normal
+	glm::vec3 orientationNormals[6]{};
+	for (s32 o = 0; o < 6; ++o)
+	{
+		const glm::vec3 rotated = rotation * GetOrientationNormal(Orientation(o));
+		orientationNormals[o] = { -rotated.x, rotated.z, rotated.y };
+	}
 
-	for (unsigned int f = 0; f < mesh->Faces.size(); ++f) 
+	for (size_t i = 0; i < vertexCount; ++i)
 	{
-		auto& faceOut = mesh->Faces[f];
-		
-		faceOut.Indices =
+		mesh->Normals[i] = orientationNormals[size_t(orientations[i])];
+	}
+
+	// Vertex colors don't sample any texture
+	if (vertexColors)
+	{
+		mesh->Colors.resize(vertexCount);
+
+		for (size_t i = 0; i < vertexCount; ++i)
 		{
-			indices[3 * f + 0],
-			indices[3 * f + 1],
-			indices[3 * f + 2]
-		};
+			// MagicaVoxel color index 1–255 → palette[ci - 1]
+			const size_t ci = colorIndices[i];
+			mesh->Colors[i] = palette[std::min(ci > 0 ? ci - 1 : 0, palette.size() - 1)];
+		}
+
+		if (paletteIndices)
+		{
+			mesh->ColorIndices = std::move(colorIndices);
+		}
+	}
+
+	if (indices16 && vertexCount <= MAX_16BIT_VERTICES)
+	{
+		mesh->Indices16.assign(indices.begin(), indices.end());
+	}
+	else
+	{
+		mesh->Indices = std::move(indices);
 	}
 
 	return mesh;
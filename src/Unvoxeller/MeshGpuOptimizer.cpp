@@ -0,0 +1,68 @@
+#include <Unvoxeller/MeshGpuOptimizer.h>
+#include <meshoptimizer/src/meshoptimizer.h>
+
+namespace Unvoxeller
+{
+	// Overdraw sorting can make the vertex cache this much worse at most.
+	static constexpr f32 OVERDRAW_CACHE_THRESHOLD = 1.05f;
+
+	template<typename T>
+	static MeshCacheStats AnalyzeIndices(const std::vector<T>& indices, size_t vertexCount)
+	{
+		const auto stats = meshopt_analyzeVertexCache(indices.data(), indices.size(), vertexCount, MeshGpuOptimizer::CACHE_SIZE, 0, 0);
+		return { stats.acmr, stats.atvr };
+	}
+
+	// Moves vertex 'i' of every attribute to 'remap[i]'.
+	template<typename T>
+	static void RemapVertices(std::vector<T>& attribute, const std::vector<u32>& remap, size_t newCount)
+	{
+		if (attribute.size() == remap.size())
+		{
+			meshopt_remapVertexBuffer(attribute.data(), attribute.data(), attribute.size(), sizeof(T), remap.data());
+			attribute.resize(newCount);
+		}
+	}
+
+	template<typename T>
+	static void OptimizeIndices(std::vector<T>& indices, UnvoxMesh& mesh)
+	{
+		const size_t vertexCount = mesh.Vertices.size();
+
+		meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertexCount);
+		meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), &mesh.Vertices[0].x, vertexCount, sizeof(glm::vec3), OVERDRAW_CACHE_THRESHOLD);
+
+		std::vector<u32> remap(vertexCount);
+		const size_t usedCount = meshopt_optimizeVertexFetchRemap(remap.data(), indices.data(), indices.size(), vertexCount);
+		meshopt_remapIndexBuffer(indices.data(), indices.data(), indices.size(), remap.data());
+
+		RemapVertices(mesh.Vertices, remap, usedCount);
+		RemapVertices(mesh.Normals, remap, usedCount);
+		RemapVertices(mesh.UVs, remap, usedCount);
+		RemapVertices(mesh.Colors, remap, usedCount);
+		RemapVertices(mesh.ColorIndices, remap, usedCount);
+	}
+
+	MeshCacheStats MeshGpuOptimizer::Analyze(const UnvoxMesh& mesh)
+	{
+		const size_t vertexCount = mesh.Vertices.size() + mesh.Quantized.GetVertexCount();
+		return mesh.Indices16.empty() ? AnalyzeIndices(mesh.Indices, vertexCount) : AnalyzeIndices(mesh.Indices16, vertexCount);
+	}
+
+	void MeshGpuOptimizer::Optimize(UnvoxMesh& mesh)
+	{
+		if (mesh.IndicesPerFace != 3 || mesh.IsQuantized() || mesh.Vertices.empty() || mesh.GetIndexCount() == 0)
+		{
+			return;
+		}
+
+		if (mesh.Indices16.empty())
+		{
+			OptimizeIndices(mesh.Indices, mesh);
+		}
+		else
+		{
+			OptimizeIndices(mesh.Indices16, mesh);
+		}
+	}
+}
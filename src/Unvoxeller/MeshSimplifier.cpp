@@ -0,0 +1,148 @@
+#include <Unvoxeller/MeshSimplifier.h>
+#include <Unvoxeller/MeshBuilder.h>
+#include <meshoptimizer/src/meshoptimizer.h>
+#include <glm/geometric.hpp>
+#include <algorithm>
+
+namespace Unvoxeller
+{
+	// Moves vertex 'i' of the attribute to 'remap[i]' of 'out', vertices that map to the same one must be identical.
+	template<typename T>
+	static void RemapVertices(const std::vector<T>& source, const std::vector<u32>& remap, size_t count, std::vector<T>& out)
+	{
+		if (!source.empty())
+		{
+			out.resize(count);
+			meshopt_remapVertexBuffer(out.data(), source.data(), source.size(), sizeof(T), remap.data());
+		}
+	}
+
+	static void RemapMesh(const UnvoxMesh& source, const std::vector<u32>& remap, size_t count, UnvoxMesh& out)
+	{
+		RemapVertices(source.Vertices, remap, count, out.Vertices);
+		RemapVertices(source.Normals, remap, count, out.Normals);
+		RemapVertices(source.UVs, remap, count, out.UVs);
+		RemapVertices(source.Colors, remap, count, out.Colors);
+		RemapVertices(source.ColorIndices, remap, count, out.ColorIndices);
+	}
+
+	// Attribute of every corner (index) of the faces.
+	template<typename T>
+	static void GatherVertices(const std::vector<T>& source, const std::vector<u32>& indices, std::vector<T>& out)
+	{
+		if (!source.empty())
+		{
+			out.resize(indices.size());
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				out[i] = source[indices[i]];
+			}
+		}
+	}
+
+	template<typename T>
+	static void AddStream(const std::vector<T>& attribute, std::vector<meshopt_Stream>& streams)
+	{
+		if (!attribute.empty())
+		{
+			streams.push_back({ attribute.data(), sizeof(T), sizeof(T) });
+		}
+	}
+
+	static std::vector<meshopt_Stream> GetStreams(const UnvoxMesh& mesh)
+	{
+		std::vector<meshopt_Stream> streams{};
+		AddStream(mesh.Vertices, streams);
+		AddStream(mesh.Normals, streams);
+		AddStream(mesh.UVs, streams);
+		AddStream(mesh.Colors, streams);
+		AddStream(mesh.ColorIndices, streams);
+		return streams;
+	}
+
+	std::shared_ptr<UnvoxMesh> MeshSimplifier::Simplify(const UnvoxMesh& mesh, f32 factor, f32 maxError, f32& error)
+	{
+		error = 0.0f;
+
+		const size_t vertexCount = mesh.Vertices.size();
+		const bool sameSizeAttributes = (mesh.Normals.empty() || mesh.Normals.size() == vertexCount) && (mesh.UVs.empty() || mesh.UVs.size() == vertexCount) &&
+										(mesh.Colors.empty() || mesh.Colors.size() == vertexCount) && (mesh.ColorIndices.empty() || mesh.ColorIndices.size() == vertexCount);
+
+		if (mesh.IndicesPerFace != 3 || mesh.IsQuantized() || vertexCount == 0 || mesh.GetIndexCount() == 0 || !sameSizeAttributes)
+		{
+			return std::make_shared<UnvoxMesh>(mesh);
+		}
+
+		std::vector<u32> indices(mesh.GetIndexCount());
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			indices[i] = mesh.GetIndex(i);
+		}
+
+		// Built meshes repeat vertices per face and voxel staircases have a flat normal crease at almost every vertex, the simplifier
+		// locks positions with more than two different vertices so nothing would collapse. Vertices are welded ignoring the normals
+		// (rebuilt below), uv/color seams and open borders still hold. Vertices are compared bitwise, so -0 has to be 0.
+		UnvoxMesh source{};
+		source.Vertices.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			source.Vertices[i] = mesh.Vertices[i] + glm::vec3(0.0f);
+		}
+
+		source.UVs = mesh.UVs;
+		source.Colors = mesh.Colors;
+		source.ColorIndices = mesh.ColorIndices;
+
+		std::vector<u32> remap(vertexCount);
+		const auto sourceStreams = GetStreams(source);
+		const size_t weldedCount = meshopt_generateVertexRemapMulti(remap.data(), indices.data(), indices.size(), vertexCount, sourceStreams.data(), sourceStreams.size());
+		meshopt_remapIndexBuffer(indices.data(), indices.data(), indices.size(), remap.data());
+
+		UnvoxMesh welded{};
+		RemapMesh(source, remap, weldedCount, welded);
+
+		const size_t targetCount = size_t(f64(indices.size() / 3) * std::clamp(factor, 0.0f, 1.0f)) * 3;
+		indices.resize(meshopt_simplify(indices.data(), indices.data(), indices.size(), &welded.Vertices[0].x, weldedCount, sizeof(glm::vec3),
+										targetCount, maxError, meshopt_SimplifyLockBorder, &error));
+
+		// Flat normals again: every corner gets the normal of its face, then identical corners are welded
+		UnvoxMesh corners{};
+		GatherVertices(welded.Vertices, indices, corners.Vertices);
+		GatherVertices(welded.UVs, indices, corners.UVs);
+		GatherVertices(welded.Colors, indices, corners.Colors);
+		GatherVertices(welded.ColorIndices, indices, corners.ColorIndices);
+
+		if (!mesh.Normals.empty())
+		{
+			corners.Normals.resize(indices.size());
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const glm::vec3* corner = &corners.Vertices[i];
+				const glm::vec3 normal = glm::normalize(glm::cross(corner[1] - corner[0], corner[2] - corner[0])) + glm::vec3(0.0f);
+				corners.Normals[i] = corners.Normals[i + 1] = corners.Normals[i + 2] = normal;
+			}
+		}
+
+		const auto cornerStreams = GetStreams(corners);
+		remap.resize(indices.size());
+		const size_t lodVertexCount = meshopt_generateVertexRemapMulti(remap.data(), nullptr, indices.size(), indices.size(), cornerStreams.data(), cornerStreams.size());
+
+		auto lod = std::make_shared<UnvoxMesh>();
+		lod->Name = mesh.Name;
+		lod->MaterialIndex = mesh.MaterialIndex;
+		lod->IndicesPerFace = mesh.IndicesPerFace;
+		RemapMesh(corners, remap, lodVertexCount, *lod);
+
+		// Corner i is vertex 'remap[i]', same index size as the source. Rebuilt flat normals can split vertices, so it can have more.
+		if (!mesh.Indices16.empty() && lodVertexCount <= MeshBuilder::MAX_16BIT_VERTICES)
+		{
+			lod->Indices16.assign(remap.begin(), remap.end());
+		}
+		else
+		{
+			lod->Indices = std::move(remap);
+		}
+
+		return lod;
+	}
+}
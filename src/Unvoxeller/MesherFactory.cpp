@@ -10,8 +10,8 @@ namespace Unvoxeller
         Elements = 
         {
             { MeshType::Greedy, std::make_shared<GreedyMesher>() },
+            { MeshType::Palette, std::make_shared<PaletteMesher>() },
             { MeshType::Voxel, std::make_shared<VoxelLikeMesher>() },
-
         };
     }
 }
@@ -0,0 +1,99 @@
+#include <Unvoxeller/MeshletBuilder.h>
+#include <meshoptimizer/src/meshoptimizer.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <algorithm>
+
+namespace Unvoxeller
+{
+	static constexpr s32 FACE_DIRECTIONS = 6;
+
+	// Face direction of the triangle (+x, -x, +y, -y, +z, -z), from its winding so it works for any normals.
+	static s32 GetFaceDirection(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+	{
+		const glm::vec3 normal = glm::cross(b - a, c - a);
+		const glm::vec3 size = glm::abs(normal);
+		const s32 axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+
+		return axis * 2 + (normal[axis] < 0.0f ? 1 : 0);
+	}
+
+	// Appends the meshlets of a set of triangles to the mesh ones.
+	static void AppendMeshlets(const std::vector<u32>& indices, UnvoxMesh& mesh, size_t maxVertices, size_t maxTriangles)
+	{
+		const size_t vertexCount = mesh.Vertices.size();
+		const f32* positions = &mesh.Vertices[0].x;
+
+		const size_t maxMeshlets = meshopt_buildMeshletsBound(indices.size(), maxVertices, maxTriangles);
+		std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+		std::vector<u32> meshletVertices(maxMeshlets * maxVertices);
+		std::vector<u8> meshletTriangles(maxMeshlets * maxTriangles * 3);
+
+		// Triangles face the same way, so there is no cone to balance against the meshlet size
+		const size_t count = meshopt_buildMeshlets(meshlets.data(), meshletVertices.data(), meshletTriangles.data(), indices.data(), indices.size(),
+												   positions, vertexCount, sizeof(glm::vec3), maxVertices, maxTriangles, 0.0f);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const meshopt_Meshlet& meshlet = meshlets[i];
+			u32* vertices = &meshletVertices[meshlet.vertex_offset];
+			u8* triangles = &meshletTriangles[meshlet.triangle_offset];
+
+			meshopt_optimizeMeshlet(vertices, triangles, meshlet.triangle_count, meshlet.vertex_count);
+			const meshopt_Bounds bounds = meshopt_computeMeshletBounds(vertices, triangles, meshlet.triangle_count, positions, vertexCount, sizeof(glm::vec3));
+
+			UnvoxMeshlet out{};
+			out.VertexOffset = u32(mesh.MeshletVertices.size());
+			out.VertexCount = meshlet.vertex_count;
+			out.TriangleOffset = u32(mesh.MeshletTriangles.size());
+			out.TriangleCount = meshlet.triangle_count;
+			out.Center = { bounds.center[0], bounds.center[1], bounds.center[2] };
+			out.Radius = bounds.radius;
+			out.ConeApex = { bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2] };
+			out.ConeAxis = { bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2] };
+			out.ConeCutoff = bounds.cone_cutoff;
+			mesh.Meshlets.push_back(out);
+
+			mesh.MeshletVertices.insert(mesh.MeshletVertices.end(), vertices, vertices + meshlet.vertex_count);
+			mesh.MeshletTriangles.insert(mesh.MeshletTriangles.end(), triangles, triangles + meshlet.triangle_count * 3);
+		}
+	}
+
+	void MeshletBuilder::Build(UnvoxMesh& mesh, u32 maxVertices, u32 maxTriangles)
+	{
+		mesh.Meshlets.clear();
+		mesh.MeshletVertices.clear();
+		mesh.MeshletTriangles.clear();
+
+		if (mesh.IndicesPerFace != 3 || mesh.IsQuantized() || mesh.Vertices.empty() || mesh.GetIndexCount() == 0)
+		{
+			return;
+		}
+
+		// Meshoptimizer limits, triangle counts have to be multiples of 4
+		const size_t vertexLimit = std::clamp<u32>(maxVertices, 3, MAX_VERTICES);
+		const size_t triangleLimit = std::clamp<u32>(maxTriangles, 4, MAX_TRIANGLES) & ~3u;
+
+		// Voxel faces only point along the axes: meshlets made of one direction have a zero width normal cone,
+		// which culls them from about half of the views, mixed ones almost never get culled.
+		std::vector<u32> directionIndices[FACE_DIRECTIONS];
+		for (size_t i = 0; i < mesh.GetIndexCount(); i += 3)
+		{
+			const u32 a = mesh.GetIndex(i), b = mesh.GetIndex(i + 1), c = mesh.GetIndex(i + 2);
+			auto& indices = directionIndices[GetFaceDirection(mesh.Vertices[a], mesh.Vertices[b], mesh.Vertices[c])];
+			indices.insert(indices.end(), { a, b, c });
+		}
+
+		for (const auto& indices : directionIndices)
+		{
+			if (!indices.empty())
+			{
+				AppendMeshlets(indices, mesh, vertexLimit, triangleLimit);
+			}
+		}
+
+		mesh.Meshlets.shrink_to_fit();
+		mesh.MeshletVertices.shrink_to_fit();
+		mesh.MeshletTriangles.shrink_to_fit();
+	}
+}
@@ -0,0 +1,81 @@
+#include <Unvoxeller/MeshletWriter.h>
+#include <Unvoxeller/Log/Log.h>
+#include <cstring>
+#include <fstream>
+
+namespace Unvoxeller
+{
+	static void AppendU32(std::vector<u8>& out, u32 value)
+	{
+		for (s32 i = 0; i < 4; ++i)
+		{
+			out.push_back(u8(value >> (i * 8)));
+		}
+	}
+
+	static void AppendF32(std::vector<u8>& out, f32 value)
+	{
+		u32 bits = 0;
+		std::memcpy(&bits, &value, sizeof(bits));
+		AppendU32(out, bits);
+	}
+
+	static void AppendVec3(std::vector<u8>& out, const glm::vec3& value)
+	{
+		AppendF32(out, value.x);
+		AppendF32(out, value.y);
+		AppendF32(out, value.z);
+	}
+
+	void MeshletWriter::Encode(const std::vector<std::shared_ptr<UnvoxMesh>>& meshes, std::vector<u8>& data)
+	{
+		data.clear();
+		AppendU32(data, MAGIC);
+		AppendU32(data, VERSION);
+		AppendU32(data, u32(meshes.size()));
+
+		for (const auto& mesh : meshes)
+		{
+			AppendU32(data, u32(mesh->Meshlets.size()));
+			AppendU32(data, u32(mesh->MeshletVertices.size()));
+			AppendU32(data, u32(mesh->MeshletTriangles.size() / 3));
+
+			for (const UnvoxMeshlet& meshlet : mesh->Meshlets)
+			{
+				AppendU32(data, meshlet.VertexOffset);
+				AppendU32(data, meshlet.VertexCount);
+				AppendU32(data, meshlet.TriangleOffset);
+				AppendU32(data, meshlet.TriangleCount);
+				AppendVec3(data, meshlet.Center);
+				AppendF32(data, meshlet.Radius);
+				AppendVec3(data, meshlet.ConeApex);
+				AppendVec3(data, meshlet.ConeAxis);
+				AppendF32(data, meshlet.ConeCutoff);
+			}
+
+			for (const u32 vertex : mesh->MeshletVertices)
+			{
+				AppendU32(data, vertex);
+			}
+
+			data.insert(data.end(), mesh->MeshletTriangles.begin(), mesh->MeshletTriangles.end());
+			data.resize((data.size() + 3) & ~size_t(3), 0);
+		}
+	}
+
+	bool MeshletWriter::Write(const std::string& path, const std::vector<std::shared_ptr<UnvoxMesh>>& meshes)
+	{
+		std::vector<u8> data{};
+		Encode(meshes, data);
+
+		std::ofstream stream(path, std::ios::out | std::ios::binary);
+		if (!stream)
+		{
+			LOG_ERROR("Can't open: {0}", path);
+			return false;
+		}
+
+		stream.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+		return bool(stream);
+	}
+}
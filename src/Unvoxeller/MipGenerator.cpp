@@ -0,0 +1,102 @@
+#include <Unvoxeller/MipGenerator.h>
+#include <Unvoxeller/ParallelFor.h>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNVOXELLER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Unvoxeller
+{
+	static inline void AverageTexels(const u8* a, const u8* b, const u8* c, const u8* d, u8* out)
+	{
+		for (s32 i = 0; i < 4; ++i)
+		{
+			out[i] = u8((a[i] + b[i] + c[i] + d[i] + 2) >> 2);
+		}
+	}
+
+	// One mip row from two source rows, 'x' texels are already done.
+	static void DownsampleRow(const u8* row0, const u8* row1, s32 width, s32 mipWidth, s32 x, u8* out)
+	{
+		for (; x < mipWidth; ++x)
+		{
+			const s32 x0 = std::min(x * 2, width - 1) * 4;
+			const s32 x1 = std::min(x * 2 + 1, width - 1) * 4;
+			AverageTexels(row0 + x0, row0 + x1, row1 + x0, row1 + x1, out + x * 4);
+		}
+	}
+
+#ifdef UNVOXELLER_SSE2
+	// Two mip texels per iteration: 4 texels of both rows are widened to 16 bits, added and rounded like 'AverageTexels'.
+	static s32 DownsampleRowSSE2(const u8* row0, const u8* row1, s32 width, s32 mipWidth, u8* out)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i rounding = _mm_set1_epi16(2);
+
+		// Both source texels of a mip texel have to be in the row
+		const s32 count = std::min(mipWidth, width / 2) & ~1;
+
+		for (s32 x = 0; x < count; x += 2)
+		{
+			const __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+			const __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+
+			// Texels 0 and 1 in 'low', 2 and 3 in 'high'
+			const __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+			const __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+
+			const __m128i lowSum = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+			const __m128i highSum = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+
+			__m128i sum = _mm_unpacklo_epi64(lowSum, highSum);
+			sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(sum, zero));
+		}
+
+		return count;
+	}
+#endif
+
+	std::vector<u8> MipGenerator::Downsample(const u8* rgba, s32 width, s32 height)
+	{
+		const s32 mipWidth = GetMipSize(width);
+		const s32 mipHeight = GetMipSize(height);
+		std::vector<u8> mip(size_t(mipWidth) * mipHeight * 4);
+
+		ParallelFor(size_t(mipHeight), 64, [&](size_t y)
+		{
+			const u8* row0 = rgba + size_t(std::min(s32(y) * 2, height - 1)) * width * 4;
+			const u8* row1 = rgba + size_t(std::min(s32(y) * 2 + 1, height - 1)) * width * 4;
+			u8* out = mip.data() + y * mipWidth * 4;
+
+			s32 done = 0;
+#ifdef UNVOXELLER_SSE2
+			done = DownsampleRowSSE2(row0, row1, width, mipWidth, out);
+#endif
+			DownsampleRow(row0, row1, width, mipWidth, done, out);
+		});
+
+		return mip;
+	}
+
+	void MipGenerator::GenerateMips(TextureData& texture, s32 levels)
+	{
+		texture.Mips.clear();
+
+		s32 width = s32(texture.Width);
+		s32 height = s32(texture.Height);
+		const u8* source = texture.Buffer.data();
+
+		for (s32 level = 0; level < levels && (width > 1 || height > 1); ++level)
+		{
+			texture.Mips.push_back(Downsample(source, width, height));
+
+			source = texture.Mips.back().data();
+			width = GetMipSize(width);
+			height = GetMipSize(height);
+		}
+	}
+}
@@ -0,0 +1,112 @@
+#include <Unvoxeller/Mesher/PaletteMesher.h>
+
+namespace Unvoxeller
+{
+    std::vector<FaceRect> PaletteMesher::CreateFaces(const vox_model& model, const vox_size& size, s32 modelIndex)
+{
+	const int X = size.x, Y = size.y, Z = size.z;
+	std::vector<FaceRect> faces;
+	faces.reserve(1024);
+
+	// MagicaVoxel color index (1–255) of a voxel, or -1 if empty/outside
+	auto getColor = [&](int x, int y, int z) -> int
+	{
+		if (x < 0 || x >= X || y < 0 || y >= Y || z < 0 || z >= Z)
+		{
+			return -1;
+		}
+
+		const int cell = model.voxel_3dGrid[z][y][x];
+		return cell < 0 ? -1 : model.voxels[cell].colorIndex;
+	};
+
+	// one 2D sweep over a "mask" of size U×V at depth w, same as the greedy mesher but only merging equal colors
+	auto sweep = [&](Orientation orient,
+		int dimU, int dimV, int dimW,
+		auto mapUVtoXYZ,        // (u,v,w)->(x,y,z) of the face-voxel
+		int adjOffset,          // offset along the sweep axis to the neighbor
+		auto getPlaneConst)     // (w)->plane coordinate
+		{
+			std::vector<int> mask(dimU * dimV);
+			std::vector<char> visited(dimU * dimV);
+
+			for (int w = 0; w < dimW; ++w)
+			{
+				// build mask[u,v] = color index if face exists, else -1
+				for (int v = 0; v < dimV; ++v)
+				{
+					for (int u = 0; u < dimU; ++u)
+					{
+						auto [fx, fy, fz] = mapUVtoXYZ(u, v, w);
+						auto [ax, ay, az] = mapUVtoXYZ(u, v, w + adjOffset);
+						const int cFace = getColor(fx, fy, fz);
+						mask[v * dimU + u] = (cFace >= 0 && getColor(ax, ay, az) < 0) ? cFace : -1;
+						visited[v * dimU + u] = 0;
+					}
+				}
+
+				// greedy-merge equal-color rects
+				for (int v = 0; v < dimV; ++v)
+				{
+					for (int u = 0; u < dimU; ++u)
+					{
+						const int idx0 = v * dimU + u;
+						const int color = mask[idx0];
+						if (color < 0 || visited[idx0]) continue;
+
+						// expand width while same color & unvisited
+						int wU = 1;
+						while (u + wU < dimU && mask[idx0 + wU] == color && !visited[idx0 + wU])
+						{
+							++wU;
+						}
+
+						// expand height as long as the whole row matches
+						int wV = 1;
+						while (v + wV < dimV)
+						{
+							const int row = (v + wV) * dimU + u;
+							bool ok = true;
+							for (int k = 0; k < wU && ok; ++k)
+							{
+								ok = mask[row + k] == color && !visited[row + k];
+							}
+
+							if (!ok) break;
+							++wV;
+						}
+
+						for (int dv = 0; dv < wV; ++dv)
+							for (int du = 0; du < wU; ++du)
+								visited[(v + dv) * dimU + (u + du)] = 1;
+
+						FaceRect f;
+						f.orientation = orient;
+						f.constantCoord = getPlaneConst(w);
+						f.uMin = u;  f.uMax = u + wU;
+						f.vMin = v;  f.vMax = v + wV;
+						f.w = wU;    f.h = wV;
+						f.colorIndex = static_cast<u8>(color);
+						f.modelIndex = modelIndex;
+						faces.push_back(f);
+					}
+				}
+			}
+		};
+
+	// +X / -X: UV=(z,y)
+	sweep(Orientation::PosX, Z, Y, X, [](int z, int y, int x) { return std::tuple{ x,y,z }; }, +1, [](int x) { return x + 1; });
+	sweep(Orientation::NegX, Z, Y, X, [](int z, int y, int x) { return std::tuple{ x,y,z }; }, -1, [](int x) { return x; });
+
+	// +Y / -Y: UV=(x,z)
+	sweep(Orientation::PosY, X, Z, Y, [](int x, int z, int y) { return std::tuple{ x,y,z }; }, +1, [](int y) { return y + 1; });
+	sweep(Orientation::NegY, X, Z, Y, [](int x, int z, int y) { return std::tuple{ x,y,z }; }, -1, [](int y) { return y; });
+
+	// +Z / -Z: UV=(x,y)
+	sweep(Orientation::PosZ, X, Y, Z, [](int x, int y, int z) { return std::tuple{ x,y,z }; }, +1, [](int z) { return z + 1; });
+	sweep(Orientation::NegZ, X, Y, Z, [](int x, int y, int z) { return std::tuple{ x,y,z }; }, -1, [](int z) { return z; });
+
+	return faces;
+}
+
+}
@@ -0,0 +1,381 @@
+#include <Unvoxeller/PngWriter.h>
+#include <Unvoxeller/ParallelFor.h>
+#include <Unvoxeller/Log/Log.h>
+#include <zlib.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+namespace Unvoxeller
+{
+	// Filtered bytes deflated by every worker, each strip is primed with the previous deflate window so the ratio stays close to a single stream.
+	static constexpr size_t STRIP_BYTES = 256 * 1024;
+	static constexpr size_t WINDOW_BYTES = 32 * 1024;
+
+	// Strips deflated at once when the rows are streamed, ~2MB of rows in memory.
+	static constexpr size_t STRIPS_PER_BAND = 8;
+
+	struct DeflatedStrip
+	{
+		std::vector<u8> Data;
+		uLong Adler = 0;
+		uLong Crc = 0;
+		size_t Size = 0;
+		bool Ok = false;
+	};
+
+	static inline s32 Paeth(s32 a, s32 b, s32 c)
+	{
+		const s32 p = a + b - c;
+		const s32 pa = std::abs(p - a);
+		const s32 pb = std::abs(p - b);
+		const s32 pc = std::abs(p - c);
+		return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+	}
+
+	static inline u32 Residual(s32 value)
+	{
+		return u32(std::abs(s32(s8(u8(value)))));
+	}
+
+	// Filters 'rowBytes' bytes of an RGBA row with the PNG filter 'type', 'prev' is a zero row for the first image row.
+	static void ApplyFilter(s32 type, const u8* row, const u8* prev, size_t rowBytes, u8* out)
+	{
+		// The first pixel has no left neighbor.
+		for (size_t i = 0; i < 4; ++i)
+		{
+			const s32 b = prev[i];
+			out[i] = u8(type == 0 || type == 1 ? row[i] : type == 3 ? row[i] - (b >> 1) : row[i] - b);
+		}
+
+		switch (type)
+		{
+		case 0: std::memcpy(out + 4, row + 4, rowBytes - 4); break;
+		case 1: for (size_t i = 4; i < rowBytes; ++i) out[i] = u8(row[i] - row[i - 4]); break;
+		case 2: for (size_t i = 4; i < rowBytes; ++i) out[i] = u8(row[i] - prev[i]); break;
+		case 3: for (size_t i = 4; i < rowBytes; ++i) out[i] = u8(row[i] - ((row[i - 4] + prev[i]) >> 1)); break;
+		default: for (size_t i = 4; i < rowBytes; ++i) out[i] = u8(row[i] - Paeth(row[i - 4], prev[i], prev[i - 4])); break;
+		}
+	}
+
+	// Same heuristic as stb and libpng: keep the filter with the smallest sum of signed residuals, all filters are scored in one pass.
+	static void FilterRow(const u8* row, const u8* prev, size_t rowBytes, bool choose, u8* out)
+	{
+		s32 bestType = 0;
+
+		if (choose)
+		{
+			u32 cost[5]{};
+
+			for (size_t i = 0; i < 4; ++i)
+			{
+				const s32 x = row[i];
+				const s32 b = prev[i];
+				cost[0] += Residual(x);
+				cost[1] += Residual(x);
+				cost[2] += Residual(x - b);
+				cost[3] += Residual(x - (b >> 1));
+				cost[4] += Residual(x - b);
+			}
+
+			for (size_t i = 4; i < rowBytes; ++i)
+			{
+				const s32 x = row[i];
+				const s32 a = row[i - 4];
+				const s32 b = prev[i];
+				const s32 c = prev[i - 4];
+
+				cost[0] += Residual(x);
+				cost[1] += Residual(x - a);
+				cost[2] += Residual(x - b);
+				cost[3] += Residual(x - ((a + b) >> 1));
+				cost[4] += Residual(x - Paeth(a, b, c));
+			}
+
+			bestType = s32(std::min_element(cost, cost + 5) - cost);
+		}
+
+		out[0] = u8(bestType);
+		ApplyFilter(bestType, row, prev, rowBytes, out + 1);
+	}
+
+	static bool DeflateStrip(const u8* filtered, size_t begin, size_t end, bool last, s32 level, DeflatedStrip& strip)
+	{
+		z_stream stream{};
+		if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			return false;
+		}
+
+		const size_t dictionaryBegin = begin - std::min(begin, WINDOW_BYTES);
+		if (level > 0 && dictionaryBegin < begin)
+		{
+			deflateSetDictionary(&stream, filtered + dictionaryBegin, uInt(begin - dictionaryBegin));
+		}
+
+		strip.Size = end - begin;
+		strip.Data.resize(deflateBound(&stream, uLong(strip.Size)) + 16);
+
+		stream.next_in = const_cast<Bytef*>(filtered + begin);
+		stream.avail_in = uInt(strip.Size);
+
+		// Strips other than the last end in a sync flush: byte aligned and not final, so they can be concatenated.
+		bool done = false;
+		while (!done)
+		{
+			stream.next_out = strip.Data.data() + stream.total_out;
+			stream.avail_out = uInt(strip.Data.size() - stream.total_out);
+
+			const s32 result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+			if (result == Z_STREAM_ERROR)
+			{
+				deflateEnd(&stream);
+				return false;
+			}
+
+			done = last ? result == Z_STREAM_END : stream.avail_out != 0;
+			if (!done)
+			{
+				strip.Data.resize(strip.Data.size() * 2);
+			}
+		}
+
+		strip.Data.resize(stream.total_out);
+		deflateEnd(&stream);
+
+		strip.Adler = adler32(1, filtered + begin, uInt(strip.Size));
+		strip.Crc = crc32(0, strip.Data.data(), uInt(strip.Data.size()));
+		strip.Ok = true;
+		return true;
+	}
+
+	static void PushU32(std::vector<u8>& out, u32 value)
+	{
+		out.push_back(u8(value >> 24));
+		out.push_back(u8(value >> 16));
+		out.push_back(u8(value >> 8));
+		out.push_back(u8(value));
+	}
+
+	static void PushChunk(std::vector<u8>& out, const char* type, const u8* data, u32 size)
+	{
+		PushU32(out, size);
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data, data + size);
+
+		uLong crc = crc32(0, reinterpret_cast<const Bytef*>(type), 4);
+		if (size > 0)
+		{
+			crc = crc32(crc, data, size);
+		}
+		PushU32(out, u32(crc));
+	}
+
+	static void PushSignatureAndHeader(std::vector<u8>& out, s32 width, s32 height)
+	{
+		const u8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		out.insert(out.end(), signature, signature + 8);
+
+		// 8 bits per channel, color type 6 (RGBA), no interlace.
+		std::vector<u8> header{};
+		PushU32(header, u32(width));
+		PushU32(header, u32(height));
+		header.insert(header.end(), { 8, 6, 0, 0, 0 });
+		PushChunk(out, "IHDR", header.data(), u32(header.size()));
+	}
+
+	// Encodes the image 'bandRows' rows at a time, every band is one IDAT chunk sent to 'output' as soon as it is deflated.
+	// 'getRows' returns the RGBA of the band rows, it only has to stay valid until the next call.
+	// Strips and deflate windows don't depend on the bands, so the zlib stream is the same for any band of whole strips.
+	static bool EncodeBands(s32 width, s32 height, s32 compressionLevel, s32 bandRows, const std::function<const u8*(s32, s32)>& getRows,
+							const std::function<bool(const u8*, size_t)>& output)
+	{
+		const s32 level = std::clamp(compressionLevel, 0, 9);
+		const size_t rowBytes = size_t(width) * 4;
+		const size_t lineBytes = rowBytes + 1;
+
+		// Whole rows per strip, strip layout doesn't depend on the core count so the output is always the same.
+		const size_t rowsPerStrip = std::max<size_t>(1, STRIP_BYTES / lineBytes);
+
+		std::vector<u8> chunks{};
+		PushSignatureAndHeader(chunks, width, height);
+		if (!output(chunks.data(), chunks.size()))
+		{
+			return false;
+		}
+
+		// zlib header, FLEVEL is only informative.
+		const u8 zlibHeader[2] = { 0x78, u8(level < 2 ? 0x01 : level < 6 ? 0x5E : level == 6 ? 0x9C : 0xDA) };
+
+		// Previous row of the band's first row, and the end of the filtered data to prime the band's first strip.
+		std::vector<u8> prevRow(rowBytes, 0);
+		std::vector<u8> filtered{};
+		uLong adler = 1;
+
+		for (s32 first = 0; first < height; first += bandRows)
+		{
+			const s32 rows = std::min(bandRows, height - first);
+			const u8* rgba = getRows(first, rows);
+			if (!rgba)
+			{
+				return false;
+			}
+
+			// Keeps the last window bytes of the previous band in front of this one.
+			const size_t window = std::min(filtered.size(), WINDOW_BYTES);
+			if (window > 0)
+			{
+				std::memmove(filtered.data(), filtered.data() + filtered.size() - window, window);
+			}
+			filtered.resize(window + lineBytes * rows);
+
+			ParallelFor(size_t(rows), 64, [&](size_t y)
+			{
+				const u8* row = rgba + y * rowBytes;
+
+				// Stored data gains nothing from filters.
+				FilterRow(row, y > 0 ? row - rowBytes : prevRow.data(), rowBytes, level > 0, filtered.data() + window + y * lineBytes);
+			});
+
+			std::memcpy(prevRow.data(), rgba + size_t(rows - 1) * rowBytes, rowBytes);
+
+			const bool lastBand = first + rows == height;
+			const size_t stripCount = (size_t(rows) + rowsPerStrip - 1) / rowsPerStrip;
+
+			std::vector<DeflatedStrip> strips(stripCount);
+			ParallelFor(stripCount, 1, [&](size_t s)
+			{
+				const size_t begin = window + s * rowsPerStrip * lineBytes;
+				const size_t end = std::min(filtered.size(), begin + rowsPerStrip * lineBytes);
+				DeflateStrip(filtered.data(), begin, end, lastBand && s + 1 == stripCount, level, strips[s]);
+			});
+
+			const bool firstBand = first == 0;
+			size_t idatSize = (firstBand ? 2 : 0) + (lastBand ? 4 : 0);
+			for (const auto& strip : strips)
+			{
+				if (!strip.Ok)
+				{
+					LOG_ERROR("Png deflate failed");
+					return false;
+				}
+				idatSize += strip.Data.size();
+			}
+
+			if (idatSize > 0x7FFFFFFFu)
+			{
+				LOG_ERROR("Png image too big: {0}x{1}", width, height);
+				return false;
+			}
+
+			uLong crc = crc32(0, reinterpret_cast<const Bytef*>("IDAT"), 4);
+			if (firstBand)
+			{
+				crc = crc32(crc, zlibHeader, 2);
+			}
+			for (const auto& strip : strips)
+			{
+				adler = adler32_combine(adler, strip.Adler, z_off_t(strip.Size));
+				crc = crc32_combine(crc, strip.Crc, z_off_t(strip.Data.size()));
+			}
+
+			const u8 adlerBytes[4] = { u8(adler >> 24), u8(adler >> 16), u8(adler >> 8), u8(adler) };
+			if (lastBand)
+			{
+				crc = crc32(crc, adlerBytes, 4);
+			}
+
+			chunks.clear();
+			chunks.reserve(idatSize + 24);
+
+			PushU32(chunks, u32(idatSize));
+			chunks.insert(chunks.end(), { 'I', 'D', 'A', 'T' });
+			if (firstBand)
+			{
+				chunks.insert(chunks.end(), zlibHeader, zlibHeader + 2);
+			}
+			for (const auto& strip : strips)
+			{
+				chunks.insert(chunks.end(), strip.Data.begin(), strip.Data.end());
+			}
+			if (lastBand)
+			{
+				chunks.insert(chunks.end(), adlerBytes, adlerBytes + 4);
+			}
+			PushU32(chunks, u32(crc));
+
+			if (lastBand)
+			{
+				PushChunk(chunks, "IEND", nullptr, 0);
+			}
+
+			if (!output(chunks.data(), chunks.size()))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool PngWriter::Encode(const u8* rgba, s32 width, s32 height, s32 compressionLevel, std::vector<u8>& png)
+	{
+		if (!rgba || width <= 0 || height <= 0)
+		{
+			return false;
+		}
+
+		png.clear();
+
+		// A single band, the image is already in memory.
+		const size_t rowBytes = size_t(width) * 4;
+		return EncodeBands(width, height, compressionLevel, height,
+			[rgba, rowBytes](s32 first, s32) { return rgba + size_t(first) * rowBytes; },
+			[&png](const u8* data, size_t size) { png.insert(png.end(), data, data + size); return true; });
+	}
+
+	bool PngWriter::WriteRows(const std::string& path, s32 width, s32 height, s32 compressionLevel, const std::function<void(s32, s32, u8*)>& drawRows)
+	{
+		if (!drawRows || width <= 0 || height <= 0)
+		{
+			return false;
+		}
+
+		std::ofstream imageStream(path, std::ios::out | std::ios::binary);
+		if (!imageStream)
+		{
+			LOG_ERROR("Can't open: {0}", path);
+			return false;
+		}
+
+		// Bands of whole strips, only the band is ever in memory.
+		const size_t lineBytes = size_t(width) * 4 + 1;
+		const s32 bandRows = s32(std::max<size_t>(1, STRIP_BYTES / lineBytes) * STRIPS_PER_BAND);
+
+		std::vector<u8> band(size_t(std::min(bandRows, height)) * width * 4);
+		return EncodeBands(width, height, compressionLevel, bandRows,
+			[&](s32 first, s32 rows) { drawRows(first, rows, band.data()); return band.data(); },
+			[&imageStream](const u8* data, size_t size) { imageStream.write(reinterpret_cast<const char*>(data), std::streamsize(size)); return bool(imageStream); });
+	}
+
+	bool PngWriter::Write(const std::string& path, const u8* rgba, s32 width, s32 height, s32 compressionLevel)
+	{
+		std::vector<u8> png{};
+		if (!Encode(rgba, width, height, compressionLevel, png))
+		{
+			return false;
+		}
+
+		std::ofstream imageStream(path, std::ios::out | std::ios::binary);
+		if (!imageStream)
+		{
+			LOG_ERROR("Can't open: {0}", path);
+			return false;
+		}
+
+		imageStream.write(reinterpret_cast<const char*>(png.data()), std::streamsize(png.size()));
+		return bool(imageStream);
+	}
+}
@@ -0,0 +1,15 @@
+#include <Unvoxeller/TextureGenerators/AtlasPackers/AtlasPackerFactory.h>
+#include <Unvoxeller/TextureGenerators/AtlasPackers/ShelfAtlasPacker.h>
+#include <Unvoxeller/TextureGenerators/AtlasPackers/SkylineAtlasPacker.h>
+
+namespace Unvoxeller
+{
+    AtlasPackerFactory::AtlasPackerFactory()
+    {
+        Elements = 
+        {
+            { AtlasPackerType::Shelf, std::make_shared<ShelfAtlasPacker>() },
+            { AtlasPackerType::Skyline, std::make_shared<SkylineAtlasPacker>() }
+        };
+    }
+}
@@ -0,0 +1,44 @@
+#include <Unvoxeller/TextureGenerators/AtlasPackers/ShelfAtlasPacker.h>
+#include <algorithm>
+
+namespace Unvoxeller
+{
+    // A simple shelf-bin packer for placing rectangles (with added border) into the atlas.
+    // Updates FaceRect atlas positions, returns how many rects fit.
+size_t ShelfAtlasPacker::Pack(s32 width, s32 height, s32 border, s32 alignment, FaceRect* rects, size_t count)
+{
+	int currentX = 0;
+	int currentY = 0;
+	int currentRowHeight = 0;
+
+	for (size_t i = 0; i < count; ++i) 
+    {
+		FaceRect& face = rects[i];
+		int rw = AlignUp(face.w + border * 2, alignment); // rect width with border
+		int rh = AlignUp(face.h + border * 2, alignment); // rect height with border
+		if (rw > width || rh > height) 
+        {
+			return i; // one rect too big to ever fit
+		}
+		if (currentX + rw > width) 
+        {
+			// start new row
+			currentY += currentRowHeight;
+			currentX = 0;
+			currentRowHeight = 0;
+		}
+		if (currentY + rh > height) 
+        {
+			return i; // height overflow
+		}
+		// place this rect
+		face.atlasX = currentX + border;
+		face.atlasY = currentY + border;
+		// update row
+		currentX += rw;
+		currentRowHeight = std::max(currentRowHeight, rh);
+	}
+	return count;
+}
+
+}
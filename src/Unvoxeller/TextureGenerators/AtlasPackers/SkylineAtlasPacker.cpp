@@ -0,0 +1,131 @@
+#include <Unvoxeller/TextureGenerators/AtlasPackers/SkylineAtlasPacker.h>
+#include <algorithm>
+#include <limits>
+
+namespace Unvoxeller
+{
+	// Horizontal segment of the skyline, everything below 'y' in [x, x + width) is already used.
+	struct SkylineNode
+	{
+		s32 x, y, width;
+	};
+
+	// Bottom-left skyline packer: every rect goes where its top edge ends lowest, ties are broken by the least wasted area
+	// below it. Unlike shelves, short rects don't waste the space above them, later rects can fill it.
+size_t SkylineAtlasPacker::Pack(s32 width, s32 height, s32 border, s32 alignment, FaceRect* rects, size_t count)
+{
+	std::vector<SkylineNode> skyline;
+	skyline.reserve(256);
+	skyline.push_back({ 0, 0, width });
+
+	for (size_t r = 0; r < count; ++r)
+	{
+		FaceRect& face = rects[r];
+		const s32 rw = AlignUp(face.w + border * 2, alignment);
+		const s32 rh = AlignUp(face.h + border * 2, alignment);
+
+		if (rw > width || rh > height)
+		{
+			return r;
+		}
+
+		s32 bestIndex = -1;
+		s32 bestTop = std::numeric_limits<s32>::max();
+		s32 bestWaste = std::numeric_limits<s32>::max();
+		s32 bestY = 0;
+
+		for (size_t i = 0; i < skyline.size(); ++i)
+		{
+			const s32 x = skyline[i].x;
+
+			if (x + rw > width)
+			{
+				break; // nodes are sorted by x, the rest won't fit either
+			}
+
+			// The rect rests on the highest segment it spans
+			s32 y = 0;
+			s32 waste = 0;
+			s32 remaining = rw;
+
+			for (size_t j = i; remaining > 0; ++j)
+			{
+				y = std::max(y, skyline[j].y);
+				remaining -= skyline[j].width;
+			}
+
+			if (y + rh > height)
+			{
+				continue;
+			}
+
+			remaining = rw;
+			for (size_t j = i; remaining > 0; ++j)
+			{
+				const s32 spanned = std::min(remaining, skyline[j].width);
+				waste += spanned * (y - skyline[j].y);
+				remaining -= spanned;
+			}
+
+			if (y + rh < bestTop || (y + rh == bestTop && waste < bestWaste))
+			{
+				bestIndex = static_cast<s32>(i);
+				bestTop = y + rh;
+				bestWaste = waste;
+				bestY = y;
+			}
+		}
+
+		if (bestIndex < 0)
+		{
+			return r;
+		}
+
+		face.atlasX = skyline[bestIndex].x + border;
+		face.atlasY = bestY + border;
+
+		// Insert the new segment and shrink/remove the ones it now covers
+		const SkylineNode node{ skyline[bestIndex].x, bestY + rh, rw };
+		skyline.insert(skyline.begin() + bestIndex, node);
+
+		for (size_t i = bestIndex + 1; i < skyline.size();)
+		{
+			const s32 nodeEnd = node.x + node.width;
+
+			if (skyline[i].x >= nodeEnd)
+			{
+				break;
+			}
+
+			const s32 shrink = nodeEnd - skyline[i].x;
+
+			if (skyline[i].width <= shrink)
+			{
+				skyline.erase(skyline.begin() + i);
+				continue;
+			}
+
+			skyline[i].x += shrink;
+			skyline[i].width -= shrink;
+			break;
+		}
+
+		// Merge neighbours at the same height
+		for (size_t i = 0; i + 1 < skyline.size();)
+		{
+			if (skyline[i].y == skyline[i + 1].y)
+			{
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase(skyline.begin() + i + 1);
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	return count;
+}
+
+}
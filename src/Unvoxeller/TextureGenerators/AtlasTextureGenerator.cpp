@@ -1,303 +1,543 @@
 #include <Unvoxeller/TextureGenerators/AtlasTextureGen.h>
 #include <Unvoxeller/Log/Log.h>
+#include <Unvoxeller/ParallelFor.h>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace Unvoxeller
 {
 
-std::shared_ptr<TextureData> AtlasTextureGenerator::GetTexture(std::vector<FaceRect>& faces, const std::vector<color>& palette,
-                                                      		   const std::vector<vox_model>& models, const bool texturesPOT)
+// Cells of 2^6 texels, more would waste most of the atlas on padding.
+static constexpr s32 MAX_ATLAS_MIPS = 6;
+
+static s32 NextPowerOfTwo(s32 value)
+{
+	s32 pot = 1;
+	while (pot < value)
+	{
+		pot <<= 1;
+	}
+	return pot;
+}
+
+// Voxel grid walk of a face, rows go along 'v' and texels along 'u', both already flipped for negative faces.
+struct FaceWalk
 {
-	s32 atlasDim = 16;
-	s32 usedW = 0;
-	s32 usedH = 0;
+	s32 x, y, z;
+	s32 ux, uy, uz;
+	s32 vx, vy, vz;
+};
 
-	if (texturesPOT)
+static bool GetFaceWalk(const FaceRect& face, FaceWalk& walk)
+{
+	const s32 c = face.constantCoord;
+	const s32 uLast = face.uMin + face.w - 1;
+	const s32 vLast = face.vMin + face.h - 1;
+
+	switch (face.orientation)
 	{
-		// Start from 16 and double
-		while (true)
+	case Orientation::PosX: walk = { c - 1, face.vMin, face.uMin, 0, 0, 1, 0, 1, 0 }; return true;  // u→Z, v→Y
+	case Orientation::NegX: walk = { c, face.vMin, uLast, 0, 0, -1, 0, 1, 0 }; return true;         // u→←Z, v→Y
+	case Orientation::PosY: walk = { face.uMin, c - 1, face.vMin, 1, 0, 0, 0, 0, 1 }; return true;  // u→X, v→Z
+	case Orientation::NegY: walk = { face.uMin, c, vLast, 1, 0, 0, 0, 0, -1 }; return true;          // u→X, v→←Z
+	case Orientation::PosZ: walk = { face.uMin, face.vMin, c - 1, 1, 0, 0, 0, 1, 0 }; return true;  // u→X, v→Y
+	case Orientation::NegZ: walk = { uLast, face.vMin, c, -1, 0, 0, 0, 1, 0 }; return true;         // u→←X, v→Y
+	default: return false;
+	}
+}
+
+// Color indices of a face, row by row in atlas orientation, so faces can be compared by content.
+static void ReadFaceColorIndices(const FaceRect& face, const vox_model& model, u8* out)
+{
+	FaceWalk walk;
+	if (!GetFaceWalk(face, walk))
+	{
+		memset(out, 0, size_t(face.w) * face.h);
+		return;
+	}
+
+	s32*** grid = model.voxel_3dGrid;
+
+	for (s32 iy = 0; iy < face.h; ++iy)
+	{
+		s32 x = walk.x + walk.vx * iy;
+		s32 y = walk.y + walk.vy * iy;
+		s32 z = walk.z + walk.vz * iy;
+
+		for (s32 ix = 0; ix < face.w; ++ix)
 		{
-			if (PackFacesIntoAtlas(atlasDim, faces))
-			{
-				break;
-			}
-			atlasDim *= 2;
-			if (atlasDim > 4096)
-			{ // safety break
-				LOG_ERROR("Could not pack texture atlas up to 4096 for frame ");// << frameIndex << "\n";
-				break;
-			}
+			const s32 cell = grid[z][y][x];
+			*out++ = cell < 0 ? 0 : model.voxels[cell].colorIndex;
+
+			x += walk.ux;
+			y += walk.uy;
+			z += walk.uz;
 		}
+	}
+}
 
-		usedW = atlasDim;
-		usedH = atlasDim;
+// Writes the rows of a face cell that are in [firstRow, firstRow + rowCount), 'pixels' starts at 'firstRow'. The cell is the face plus 'border' texels on every side
+// and whatever it needs on the right and bottom to get to 'alignment' (see 'AtlasPackerBase::Pack'), padding repeats the face edges.
+// Faces never share texels, so this can run concurrently.
+static void RasterizeFace(const FaceRect& face, const vox_model& model, const u32* colors, s32 border, s32 alignment, s32 texWidth, s32 firstRow, s32 rowCount, u32* pixels)
+{
+	FaceWalk walk;
+	if (!GetFaceWalk(face, walk))
+	{
+		return;
 	}
-	else
+
+	const s32 w = face.w;
+	const s32 h = face.h;
+	const s32 right = AlignUp(w + border * 2, alignment) - w - border;
+	const s32 bottom = AlignUp(h + border * 2, alignment) - h - border;
+	const size_t spanBytes = (border + w + right) * sizeof(u32);
+	s32*** grid = model.voxel_3dGrid;
+
+	const s32 begin = std::max(face.atlasY - border, firstRow);
+	const s32 end = std::min(face.atlasY + h + bottom, firstRow + rowCount);
+
+	for (s32 ty = begin; ty < end; ++ty)
 	{
-		// Start with 16 and grow by 16 steps or double as needed (non-POT allowed)
-		while (true)
+		u32* row = pixels + size_t(ty - firstRow) * texWidth + face.atlasX;
+
+		// Top & bottom padding rows repeat the first/last face row, corners included
+		const s32 iy = std::clamp(ty - face.atlasY, 0, h - 1);
+		if (ty > begin && iy == std::clamp(ty - 1 - face.atlasY, 0, h - 1))
 		{
-			if (PackFacesIntoAtlas(atlasDim, faces))
+			memcpy(row - border, row - texWidth - border, spanBytes);
+			continue;
+		}
+
+		s32 x = walk.x + walk.vx * iy;
+		s32 y = walk.y + walk.vy * iy;
+		s32 z = walk.z + walk.vz * iy;
+
+		for (s32 ix = 0; ix < w; ++ix)
+		{
+			const s32 cell = grid[z][y][x];
+			row[ix] = colors[cell < 0 ? 0 : model.voxels[cell].colorIndex];
+
+			x += walk.ux;
+			y += walk.uy;
+			z += walk.uz;
+		}
+
+		// Left & right padding
+		std::fill(row - border, row, row[0]);
+		std::fill(row + w, row + w + right, row[w - 1]);
+	}
+}
+
+// Groups faces by the texels they would draw (same size and color indices in atlas orientation) when 'sameTexels' is set,
+// without 'sameModel' only faces of different models are grouped, and single colored faces by their color when 'sameColors' is set, those become a 1x1 face and get flagged as 'uniformColor'.
+// 'uniqueIndices[i]' is the index in 'uniqueFaces' of the face that 'faces[i]' can reuse, 'uniqueFaces' keeps the faces order.
+static void GetUniqueFaces(std::vector<FaceRect>& faces, const std::vector<AtlasModel>& models, bool sameTexels, bool sameModel, bool sameColors,
+						   std::vector<FaceRect>& uniqueFaces, std::vector<size_t>& uniqueIndices)
+{
+	std::vector<size_t> offsets(faces.size() + 1, 0);
+	for (size_t i = 0; i < faces.size(); ++i)
+	{
+		offsets[i + 1] = offsets[i] + size_t(faces[i].w) * faces[i].h;
+	}
+
+	std::vector<u8> texels(offsets.back());
+	std::vector<u64> hashes(faces.size());
+
+	ParallelFor(faces.size(), 256, [&](size_t i)
+	{
+		FaceRect& face = faces[i];
+		u8* content = texels.data() + offsets[i];
+		const size_t size = offsets[i + 1] - offsets[i];
+
+		ReadFaceColorIndices(face, *models[face.modelIndex].Model, content);
+
+		face.uniformColor = sameColors && std::all_of(content, content + size, [content](u8 ci) { return ci == content[0]; });
+
+		const s32 w = face.uniformColor ? 1 : face.w;
+		const s32 h = face.uniformColor ? 1 : face.h;
+
+		// FNV-1a
+		u64 hash = 14695981039346656037ull;
+		auto mix = [&hash](u8 value) { hash = (hash ^ value) * 1099511628211ull; };
+
+		mix(u8(w)); mix(u8(w >> 8));
+		mix(u8(h)); mix(u8(h >> 8));
+
+		for (size_t t = 0; t < size_t(w) * h; ++t)
+		{
+			mix(content[t]);
+		}
+
+		hashes[i] = hash;
+	});
+
+	// hash -> faces in 'uniqueFaces' (index in 'faces' of the first one, and its unique index)
+	std::unordered_map<u64, std::vector<std::pair<size_t, size_t>>> buckets{};
+	buckets.reserve(faces.size());
+
+	// Unique faces every model already uses, see 'sameModel'
+	std::unordered_set<u64> modelTexels{};
+	auto GetModelTexelsKey = [](size_t unique, s32 modelIndex) { return (u64(unique) << 32) | u32(modelIndex); };
+
+	uniqueFaces.clear();
+	uniqueIndices.resize(faces.size());
+
+	for (size_t i = 0; i < faces.size(); ++i)
+	{
+		FaceRect face = faces[i];
+
+		if (face.uniformColor)
+		{
+			face.w = 1;
+			face.h = 1;
+		}
+		else if (!sameTexels)
+		{
+			uniqueIndices[i] = uniqueFaces.size();
+			uniqueFaces.push_back(face);
+			continue;
+		}
+
+		auto& bucket = buckets[hashes[i]];
+
+		bool found = false;
+		for (const auto& [source, unique] : bucket)
+		{
+			const FaceRect& other = uniqueFaces[unique];
+
+			// Same indices are only the same colors with the same palette
+			if (models[other.modelIndex].Colors != models[face.modelIndex].Colors)
 			{
-				break;
+				continue;
 			}
 
-			atlasDim += 16;
+			// Without 'sameModel', a model never gets two faces on the same texels
+			const bool modelChecked = !face.uniformColor && !sameModel;
+			if (modelChecked && modelTexels.count(GetModelTexelsKey(unique, face.modelIndex)))
+			{
+				continue;
+			}
 
-			if (atlasDim > 4096)
+			if (other.w == face.w && other.h == face.h &&
+				memcmp(texels.data() + offsets[source], texels.data() + offsets[i], size_t(face.w) * face.h) == 0)
 			{
-				LOG_ERROR("Could not pack texture atlas up to 4096 for frame ");
+				uniqueIndices[i] = unique;
+				found = true;
+
+				if (modelChecked)
+				{
+					modelTexels.insert(GetModelTexelsKey(unique, face.modelIndex));
+				}
 				break;
 			}
 		}
-		// Shrink to actual used size
-		// We can compute used width and height from faces placement
-		for (auto& fr : faces)
+
+		if (!found)
 		{
-			usedW = std::max(usedW, fr.atlasX + fr.w + 2);
-			usedH = std::max(usedH, fr.atlasY + fr.h + 2);
+			uniqueIndices[i] = uniqueFaces.size();
+			if (!sameModel)
+			{
+				modelTexels.insert(GetModelTexelsKey(uniqueFaces.size(), face.modelIndex));
+			}
+			bucket.push_back({ i, uniqueFaces.size() });
+			uniqueFaces.push_back(face);
 		}
+	}
+}
 
-		atlasDim = std::max(usedW, usedH);
+// RGBA of every MagicaVoxel colorIndex (1–255), so drawing a texel is a single lookup.
+static std::shared_ptr<const std::array<u32, 256>> GetPaletteColors(const std::vector<color>& palette)
+{
+	auto colors = std::make_shared<std::array<u32, 256>>();
+	for (s32 ci = 0; ci < 256; ++ci)
+	{
+		size_t idx = ci > 0 ? ci - 1 : 0;
+		if (idx >= palette.size()) idx = palette.size() - 1;
+		memcpy(&(*colors)[ci], &palette[idx], sizeof(u32));
 	}
 
-	// Create image
-	auto textureData = std::make_shared<TextureData>();
-	textureData->Width = usedW;
-	textureData->Height = usedH;
+	return colors;
+}
 
-	LOG_INFO("Texture size: ({0}, {1})", textureData->Width, textureData->Height);
+std::vector<std::shared_ptr<TextureData>> AtlasTextureGenerator::GetTextures(std::vector<FaceRect>& faces, const std::vector<color>& palette,
+                                                      		   const std::vector<vox_model>& models, const TexturingOptions& options)
+{
+	const auto colors = GetPaletteColors(palette);
 
-	GenerateAtlasImage(atlasDim, atlasDim, faces, models, palette, textureData->Buffer);
+	std::vector<AtlasModel> atlasModels(models.size());
+	for (size_t i = 0; i < models.size(); ++i)
+	{
+		atlasModels[i] = { &models[i], colors };
+	}
 
-	return textureData;
+	return GetAtlasTextures(faces, atlasModels, options);
 }
 
-
-    // A simple shelf-bin packer for placing rectangles (with added border) into a square atlas of given dimension.
-    // Returns true and updates FaceRect atlas positions if successful, or false if not fitting.
-bool AtlasTextureGenerator::PackFacesIntoAtlas(int atlasSize, std::vector<FaceRect>& rects)
+std::vector<std::shared_ptr<TextureData>> AtlasTextureGenerator::GetBatchTextures(std::vector<TextureBatchFile>& files, const TexturingOptions& options)
 {
-	// Sort rectangles by height (descending) for better packing (larger first).
-	std::sort(rects.begin(), rects.end(), [](const FaceRect& a, const FaceRect& b)
+	// Faces of all the files together, model indices are offset to point to the models of their file.
+	std::vector<std::shared_ptr<const std::array<u32, 256>>> colors(files.size());
+	std::vector<AtlasModel> atlasModels{};
+	std::vector<s32> modelOffsets(files.size());
+	std::vector<FaceRect> faces{};
+
+	for (size_t f = 0; f < files.size(); ++f)
+	{
+		colors[f] = GetPaletteColors(*files[f].Palette);
+		modelOffsets[f] = static_cast<s32>(atlasModels.size());
+
+		// Files with the same palette (ex: the default one) share the colors, so their faces can be merged.
+		for (size_t other = 0; other < f; ++other)
 		{
-			// compare (h+2) including border
-			int ah = a.h + 2;
-			int bh = b.h + 2;
-			if (ah == bh) {
-				// if heights equal, maybe sort by width as well
-				return (a.w + 2) > (b.w + 2);
+			if (*colors[other] == *colors[f])
+			{
+				colors[f] = colors[other];
+				break;
 			}
-			return ah > bh;
-		});
-
-	int currentX = 0;
-	int currentY = 0;
-	int currentRowHeight = 0;
-	int usedHeight = 0;
-
-	for (auto& face : rects) 
-    {
-		int rw = face.w + 2; // rect width with border
-		int rh = face.h + 2; // rect height with border
-		if (rw > atlasSize || rh > atlasSize) 
-        {
-			return false; // one rect too big to ever fit
-		}
-		if (currentX + rw > atlasSize) 
-        {
-			// start new row
-			currentY += currentRowHeight;
-			currentX = 0;
-			currentRowHeight = 0;
-		}
-		if (currentY + rh > atlasSize) 
-        {
-			return false; // height overflow
 		}
-		// place this rect
-		face.atlasX = currentX;
-		face.atlasY = currentY;
-		// update row
-		currentX += rw;
-		if (rh > currentRowHeight) 
-        {
-			currentRowHeight = rh;
+
+		for (const auto& model : *files[f].Models)
+		{
+			atlasModels.push_back({ &model, colors[f] });
 		}
-		usedHeight = std::max(usedHeight, currentY + currentRowHeight);
-		if (usedHeight > atlasSize) 
-        {
-			return false;
+
+		for (FaceRect face : *files[f].Faces)
+		{
+			face.modelIndex += modelOffsets[f];
+			faces.push_back(face);
 		}
+
+		files[f].Faces->clear();
 	}
-	return true;
-}
 
+	std::vector<std::shared_ptr<TextureData>> textures = GetAtlasTextures(faces, atlasModels, options);
 
+	// Back to their files, with the file's model indices
+	for (FaceRect& face : faces)
+	{
+		const size_t f = std::upper_bound(modelOffsets.begin(), modelOffsets.end(), face.modelIndex) - modelOffsets.begin() - 1;
+		face.modelIndex -= modelOffsets[f];
+		files[f].Faces->push_back(face);
+	}
 
+	return textures;
+}
 
-// Generate the texture atlas image data given the list of faces and palette colors
-void AtlasTextureGenerator::GenerateAtlasImage(s32 texWidth,
-	s32 texHeight,
-	const std::vector<FaceRect>& faces,
-	const std::vector<vox_model>& models,
-	const std::vector<color>& palette,
-	std::vector<unsigned char>& outImage)
+std::vector<std::shared_ptr<TextureData>> AtlasTextureGenerator::GetAtlasTextures(std::vector<FaceRect>& faces, const std::vector<AtlasModel>& models, const TexturingOptions& options)
 {
-	const int border = 1;
-	outImage.assign(texWidth * texHeight * 4, 0);
+	// Sort rectangles by height (descending) for better packing (larger first), only once, packers keep this order.
+	std::sort(faces.begin(), faces.end(), [](const FaceRect& a, const FaceRect& b)
+		{
+			if (a.h == b.h) 
+			{
+				return a.w > b.w;
+			}
+			return a.h > b.h;
+		});
 
-	// Helper to fetch RGBA from palette given a MagicaVoxel colorIndex (1–255)
-	auto getRGBA = [&](uint8_t ci) 
+	if (!options.OptimizeTextures && !options.ReuseColors && !options.SharedFramesAtlas)
 	{
-		size_t idx = ci > 0 ? ci - 1 : 0;
-		if (idx >= palette.size()) idx = palette.size() - 1;
-		return palette[idx];
-		};
+		for (auto& face : faces)
+		{
+			face.uniformColor = false;
+		}
 
-	// Sample the colorIndex at a given (x,y,z)
-	auto sampleCI = [&](int x, int y, int z, s32 modelIndex)->uint8_t 
-	{
-		int cell = models[modelIndex].voxel_3dGrid[z][y][x];
-		if (cell < 0) return 0;
-		return models[modelIndex].voxels[cell].colorIndex;
-		};
+		return PackPages(faces, models, options);
+	}
+
+	// Only one face of every group with the same texels gets packed and drawn, the rest copy its atlas location.
+	std::vector<FaceRect> uniqueFaces{};
+	std::vector<size_t> uniqueIndices{};
+	GetUniqueFaces(faces, models, options.OptimizeTextures || options.SharedFramesAtlas, options.OptimizeTextures, options.ReuseColors, uniqueFaces, uniqueIndices);
 
-	for (auto& face : faces) 
+	LOG_INFO("Unique face textures: {0} of {1}", uniqueFaces.size(), faces.size());
+
+	// Collapsed faces shrunk to 1x1, sort again so the packer gets the big ones first.
+	std::vector<size_t> order(uniqueFaces.size());
+	for (size_t i = 0; i < order.size(); ++i)
 	{
-		int x0 = face.atlasX;
-		int y0 = face.atlasY;
-		int w = face.w;
-		int h = face.h;
+		order[i] = i;
+	}
 
-		// 1) Fill interior (w×h) by sampling the original voxels
-		for (int iy = 0; iy < h; ++iy) 
+	std::stable_sort(order.begin(), order.end(), [&uniqueFaces](size_t a, size_t b)
 		{
-			for (int ix = 0; ix < w; ++ix) 
+			if (uniqueFaces[a].h == uniqueFaces[b].h)
 			{
-				int vx, vy, vz;
-				switch (face.orientation) 
-				{
-				case Orientation::PosX: // +X face: plane at x+1, u→Z, v→Y
-					vx = face.constantCoord - 1;
-					vy = face.vMin + iy;
-					vz = face.uMin + ix;
-					break;
-				case Orientation::NegX: // -X face: plane at x,  u→←Z, v→Y
-					vx = face.constantCoord;
-					vy = face.vMin + iy;
-					vz = face.uMin + (w - 1 - ix);
-					break;
-				case Orientation::PosY: // +Y face: plane at y+1, u→X, v→Z
-					vx = face.uMin + ix;
-					vy = face.constantCoord - 1;
-					vz = face.vMin + iy;
-					break;
-				case Orientation::NegY: // -Y face: plane at y,  u→X, v→←Z
-					vx = face.uMin + ix;
-					vy = face.constantCoord;
-					vz = face.vMin + (h - 1 - iy);
-					break;
-				case Orientation::PosZ: // +Z face: plane at z+1, u→X, v→Y
-					vx = face.uMin + ix;
-					vy = face.vMin + iy;
-					vz = face.constantCoord - 1;
-					break;
-				case Orientation::NegZ: // -Z face: plane at z,  u→←X, v→Y
-					vx = face.uMin + (w - 1 - ix);
-					vy = face.vMin + iy;
-					vz = face.constantCoord;
-					break;
-				default:
-					continue;
-				}
+				return uniqueFaces[a].w > uniqueFaces[b].w;
+			}
+			return uniqueFaces[a].h > uniqueFaces[b].h;
+		});
+
+	std::vector<FaceRect> sortedFaces(uniqueFaces.size());
+	std::vector<size_t> sortedIndices(uniqueFaces.size());
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		sortedFaces[i] = uniqueFaces[order[i]];
+		sortedIndices[order[i]] = i;
+	}
+
+	std::vector<std::shared_ptr<TextureData>> textures = PackPages(sortedFaces, models, options);
+
+	for (size_t i = 0; i < faces.size(); ++i)
+	{
+		const FaceRect& unique = sortedFaces[sortedIndices[uniqueIndices[i]]];
+		faces[i].atlasX = unique.atlasX;
+		faces[i].atlasY = unique.atlasY;
+		faces[i].atlasPage = unique.atlasPage;
+	}
 
-				uint8_t ci = sampleCI(vx, vy, vz, face.modelIndex);
-				auto col = getRGBA(ci);
+	return textures;
+}
+
+std::vector<std::shared_ptr<TextureData>> AtlasTextureGenerator::PackPages(std::vector<FaceRect>& faces, const std::vector<AtlasModel>& models, const TexturingOptions& options)
+{
+	const s32 border = options.AtlasBorders ? 1 : 0;
+	const s32 alignment = 1 << std::clamp(options.AtlasMips, 0, MAX_ATLAS_MIPS);
+	const s32 maxAtlasSize = options.TexturesPOT ? NextPowerOfTwo(options.MaxAtlasSize + 1) / 2 : options.MaxAtlasSize;
+	const std::shared_ptr<AtlasPackerBase> packer = _packerFactory.Get(options.Packer);
+
+	// Faces get their page once they are packed
+	for (auto& face : faces)
+	{
+		face.atlasPage = -1;
+	}
 
-				int px = x0 + border + ix;
-				int py = y0 + border + iy;
-				int idx = (py * texWidth + px) * 4;
-				outImage[idx + 0] = col.r;
-				outImage[idx + 1] = col.g;
-				outImage[idx + 2] = col.b;
-				outImage[idx + 3] = col.a;
+	std::vector<std::shared_ptr<TextureData>> textures{};
+
+	// Every iteration fills one page, with the faces that didn't fit in the previous ones.
+	size_t first = 0;
+	do
+	{
+		const s32 page = static_cast<s32>(textures.size());
+		const size_t count = faces.size() - first;
+
+		// Estimate a tight width from the total area, the height is whatever the packer ends up using.
+		s64 totalArea = 0;
+		s32 widest = 16;
+
+		for (size_t i = first; i < faces.size(); ++i)
+		{
+			totalArea += s64(AlignUp(faces[i].w + border * 2, alignment)) * AlignUp(faces[i].h + border * 2, alignment);
+			widest = std::max(widest, AlignUp(faces[i].w + border * 2, alignment));
+		}
+
+		s32 atlasWidth = std::max(widest, static_cast<s32>(std::ceil(std::sqrt(static_cast<f64>(totalArea)))));
+		atlasWidth = std::min(maxAtlasSize, options.TexturesPOT ? NextPowerOfTwo(atlasWidth) : atlasWidth);
+
+		size_t packed = 0;
+		while (true)
+		{
+			packed = packer->Pack(atlasWidth, maxAtlasSize, border, alignment, faces.data() + first, count);
+
+			if (packed == count || atlasWidth >= maxAtlasSize)
+			{
+				break;
 			}
+
+			// Too tall, make it wider
+			atlasWidth = std::min(maxAtlasSize, options.TexturesPOT ? atlasWidth * 2 : atlasWidth + std::max(16, atlasWidth / 8));
 		}
 
-		// 2) Bleed edges into the 1-pixel border on all four sides:
+		if (packed == 0 && count > 0)
+		{
+			LOG_ERROR("Face of size ({0}, {1}) doesn't fit in an atlas of max size {2}, it gets its own bigger page", faces[first].w, faces[first].h, maxAtlasSize);
+
+			// The face alone in a page of its size, the rest keep packing in the next ones.
+			faces[first].atlasX = border;
+			faces[first].atlasY = border;
+			packed = 1;
+		}
 
-		// Top & bottom
-		for (int ix = 0; ix < w; ++ix) 
+		// Shrink to actual used size
+		s32 usedW = 0;
+		s32 usedH = 0;
+		s64 usedArea = 0;
+
+		for (size_t i = first; i < first + packed; ++i)
 		{
-			// copy from first interior row → top border
-			int srcTop = ((y0 + border + 0) * texWidth + (x0 + border + ix)) * 4;
-			int dstTop = ((y0 + 0) * texWidth + (x0 + border + ix)) * 4;
-			memcpy(&outImage[dstTop], &outImage[srcTop], 4);
-
-			// copy from last interior row → bottom border
-			int srcBot = ((y0 + border + h - 1) * texWidth + (x0 + border + ix)) * 4;
-			int dstBot = ((y0 + border + h) * texWidth + (x0 + border + ix)) * 4;
-			memcpy(&outImage[dstBot], &outImage[srcBot], 4);
+			FaceRect& fr = faces[i];
+			fr.atlasPage = page;
+			const s32 cellW = AlignUp(fr.w + border * 2, alignment);
+			const s32 cellH = AlignUp(fr.h + border * 2, alignment);
+			usedW = std::max(usedW, fr.atlasX - border + cellW);
+			usedH = std::max(usedH, fr.atlasY - border + cellH);
+			usedArea += s64(cellW) * cellH;
 		}
 
-		// Left & right
-		for (int iy = 0; iy < h; ++iy) 
+		if (options.TexturesPOT)
 		{
-			// copy from first interior column → left border
-			int srcL = ((y0 + border + iy) * texWidth + (x0 + border + 0)) * 4;
-			int dstL = ((y0 + border + iy) * texWidth + (x0 + 0)) * 4;
-			memcpy(&outImage[dstL], &outImage[srcL], 4);
-
-			// copy from last interior column → right border
-			int srcR = ((y0 + border + iy) * texWidth + (x0 + border + w - 1)) * 4;
-			int dstR = ((y0 + border + iy) * texWidth + (x0 + border + w)) * 4;
-			memcpy(&outImage[dstR], &outImage[srcR], 4);
+			usedW = NextPowerOfTwo(usedW);
+			usedH = NextPowerOfTwo(usedH);
 		}
 
-		// Finally fill corners by copying the appropriate interior pixel:
-		// top-left corner
-		memcpy(
-			&outImage[((y0 + 0) * texWidth + (x0 + 0)) * 4],
-			&outImage[((y0 + border) * texWidth + (x0 + border)) * 4],
-			4
-		);
-		// top-right
-		memcpy(
-			&outImage[((y0 + 0) * texWidth + (x0 + border + w)) * 4],
-			&outImage[((y0 + border) * texWidth + (x0 + border + w - 1)) * 4],
-			4
-		);
-		// bottom-left
-		memcpy(
-			&outImage[((y0 + border + h) * texWidth + (x0 + 0)) * 4],
-			&outImage[((y0 + border + h - 1) * texWidth + (x0 + border)) * 4],
-			4
-		);
-		// bottom-right
-		memcpy(
-			&outImage[((y0 + border + h) * texWidth + (x0 + border + w)) * 4],
-			&outImage[((y0 + border + h - 1) * texWidth + (x0 + border + w - 1)) * 4],
-			4
-		);
+		usedW = std::max(usedW, alignment);
+		usedH = std::max(usedH, alignment);
+
+		// Create image
+		auto textureData = std::make_shared<TextureData>();
+		textureData->Width = usedW;
+		textureData->Height = usedH;
+
+		LOG_INFO("Texture page {0} size: ({1}, {2}), fill ratio: {3}", page, usedW, usedH, static_cast<f64>(usedArea) / (s64(usedW) * usedH));
+
+		// Drawn whole or a band at a time by the caller, it draws from the models so it can't outlive them.
+		textureData->DrawRows = GetPageDrawer(usedW, page, border, alignment, faces, models);
+
+		textures.push_back(textureData);
+		first += packed;
+
+	} while (first < faces.size());
+
+	if (textures.size() > 1)
+	{
+		LOG_WARN("Faces didn't fit in a single {0}x{0} atlas, pages: {1}", maxAtlasSize, textures.size());
+	}
+
+	return textures;
+}
+
+// Drawer of any rows of a page. It keeps the page faces sorted by their first cell row, so a band only walks the faces that can cross it.
+std::function<void(s32, s32, u8*)> AtlasTextureGenerator::GetPageDrawer(s32 texWidth, s32 page, s32 border, s32 alignment,
+																		   const std::vector<FaceRect>& faces, const std::vector<AtlasModel>& models)
+{
+	std::vector<FaceRect> pageFaces{};
+	s32 tallestCell = 0;
+
+	for (const auto& face : faces)
+	{
+		if (face.atlasPage == page)
+		{
+			pageFaces.push_back(face);
+			tallestCell = std::max(tallestCell, AlignUp(face.h + border * 2, alignment));
+		}
 	}
 
+	std::sort(pageFaces.begin(), pageFaces.end(), [](const FaceRect& a, const FaceRect& b) { return a.atlasY < b.atlasY; });
+
+	return [=](s32 firstRow, s32 rowCount, u8* rgba)
+	{
+		std::fill(rgba, rgba + size_t(texWidth) * rowCount * 4, u8(0));
 
-	// auto flipVertical = [&](std::vector<unsigned char>& img, int w, int h) {
-	// 	const int rowBytes = w * 4;
-	// 	std::vector<unsigned char> tmp(rowBytes);
-	// 	for (int y = 0; y < h/2; ++y) {
-	// 		int topIndex = y * rowBytes;
-	// 		int botIndex = (h - 1 - y) * rowBytes;
-	// 		// swap the entire row
-	// 		std::memcpy(tmp.data(),        &img[topIndex], rowBytes);
-	// 		std::memcpy(&img[topIndex],   &img[botIndex], rowBytes);
-	// 		std::memcpy(&img[botIndex],   tmp.data(),      rowBytes);
-	// 	}
-	// };
+		// Cells start 'border' texels above their face and are at most 'tallestCell' rows
+		const auto byRow = [](const FaceRect& face, s32 row) { return face.atlasY < row; };
+		const auto begin = std::lower_bound(pageFaces.begin(), pageFaces.end(), firstRow - tallestCell + border + 1, byRow);
+		const auto end = std::lower_bound(begin, pageFaces.end(), firstRow + rowCount + border, byRow);
 
-	// flipVertical(outImage, texWidth, texHeight);
+		u32* pixels = reinterpret_cast<u32*>(rgba);
 
+		ParallelFor(size_t(end - begin), 64, [&](size_t i)
+		{
+			const FaceRect& face = *(begin + i);
+			const AtlasModel& model = models[face.modelIndex];
+			RasterizeFace(face, *model.Model, model.Colors->data(), border, alignment, texWidth, firstRow, rowCount, pixels);
+		});
+	};
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <Unvoxeller/TextureGenerators/PaletteTextureGen.h>
+#include <Unvoxeller/Log/Log.h>
+#include <algorithm>
+
+namespace Unvoxeller
+{
+
+static s32 NextPowerOfTwo(s32 value)
+{
+	s32 pot = 1;
+	while (pot < value)
+	{
+		pot <<= 1;
+	}
+	return pot;
+}
+
+std::vector<std::shared_ptr<TextureData>> PaletteTextureGenerator::GetTextures(std::vector<FaceRect>& faces, const std::vector<color>& palette,
+                                                      		   const std::vector<vox_model>& /*models*/, const TexturingOptions& options)
+{
+	// MagicaVoxel color indices go from 1 to 255 (0 is empty), 'palette[ci - 1]'
+	const s32 colorCount = 255;
+	const bool columns = options.Palette.UseColumns;
+	const s32 max = std::clamp(options.Palette.Max, 1, colorCount);
+	const s32 lines = (colorCount + max - 1) / max;
+
+	s32 width = columns ? lines : max;
+	s32 height = columns ? max : lines;
+
+	if (options.TexturesPOT)
+	{
+		width = NextPowerOfTwo(width);
+		height = NextPowerOfTwo(height);
+	}
+
+	auto getTexel = [&](u8 ci, s32& x, s32& y)
+	{
+		const s32 i = ci > 0 ? ci - 1 : 0;
+		x = columns ? i / max : i % max;
+		y = columns ? i % max : i / max;
+	};
+
+	auto textureData = std::make_shared<TextureData>();
+	textureData->Width = width;
+	textureData->Height = height;
+	textureData->Buffer.assign(size_t(width) * height * 4, 0);
+
+	for (s32 ci = 1; ci <= colorCount; ++ci)
+	{
+		const size_t idx = std::min<size_t>(ci - 1, palette.size() - 1);
+
+		s32 x, y;
+		getTexel(static_cast<u8>(ci), x, y);
+
+		unsigned char* texel = &textureData->Buffer[(size_t(y) * width + x) * 4];
+		texel[0] = palette[idx].r;
+		texel[1] = palette[idx].g;
+		texel[2] = palette[idx].b;
+		texel[3] = palette[idx].a;
+	}
+
+	// Every face points at the texel of its color
+	for (auto& face : faces)
+	{
+		s32 x, y;
+		getTexel(face.colorIndex, x, y);
+
+		face.atlasX = x;
+		face.atlasY = y;
+		face.atlasPage = 0;
+		face.uniformColor = true;
+	}
+
+	LOG_INFO("Palette texture size: ({0}, {1})", width, height);
+
+	return { textureData };
+}
+
+}
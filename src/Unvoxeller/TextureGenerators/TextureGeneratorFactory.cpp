@@ -1,5 +1,6 @@
 #include <Unvoxeller/TextureGenerators/TextureGeneratorFactory.h>
 #include <Unvoxeller/TextureGenerators/AtlasTextureGen.h>
+#include <Unvoxeller/TextureGenerators/PaletteTextureGen.h>
 
 namespace Unvoxeller
 {
@@ -7,7 +8,8 @@ namespace Unvoxeller
     {
         Elements = 
         {
-            { TextureType::Atlas, std::make_shared<AtlasTextureGenerator>() }
+            { TextureType::Atlas, std::make_shared<AtlasTextureGenerator>() },
+            { TextureType::Palette, std::make_shared<PaletteTextureGenerator>() }
         };
     }
 }
\ No newline at end of file
@@ -1,19 +1,33 @@
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
 #include <string>
 #include <memory>
 #include <cassert>
+#include <future>
+#include <thread>
+#include <filesystem>
 #include <Unvoxeller/Unvoxeller.h>
 #include <Unvoxeller/FaceRect.h>
 #include <Unvoxeller/VoxParser.h>
 #include <Unvoxeller/Log/Log.h>
 #include <Unvoxeller/VertexMerger.h>
+#include <Unvoxeller/VertexQuantizer.h>
+#include <Unvoxeller/MeshGpuOptimizer.h>
+#include <Unvoxeller/MeshletBuilder.h>
+#include <Unvoxeller/MeshletWriter.h>
+#include <Unvoxeller/MeshSimplifier.h>
+#include <Unvoxeller/VoxelDownsampler.h>
+#include <Unvoxeller/ParallelFor.h>
 #include <Unvoxeller/ScenePostprocessing.h>
 #include <Unvoxeller/AssimpSceneWritter.h>
 #include <Unvoxeller/Mesher/MesherFactory.h>
 #include <Unvoxeller/TextureGenerators/TextureGeneratorFactory.h>
 #include <Unvoxeller/MeshBuilder.h>
-#include <stb/stb_image_write.h>
+#include <Unvoxeller/PngWriter.h>
+#include <Unvoxeller/KtxWriter.h>
+#include <Unvoxeller/MipGenerator.h>
 
 // Assume the Unvoxeller namespace and structures from the provided data structure are available:
 namespace Unvoxeller
@@ -108,20 +122,475 @@ namespace Unvoxeller
 		return world;
 	}
 
-	// Create and save a PNG texture from the atlas data
-	static bool SaveAtlasImage(const std::string& filename, int width, int height, const std::vector<unsigned char>& rgbaData)
+	// Faces of every model already meshed while the file was being read (see 'PipelinedParsing'), indexed by model id.
+	using MeshedModels = std::vector<std::vector<FaceRect>>;
+
+	// Palette textures and vertex colors only have one color per face, so faces can't mix colors.
+	static MeshType GetMeshType(const ConvertOptions& options)
+	{
+		const bool singleColorFaces = options.Meshing.VertexColors || options.Texturing.TextureType == TextureType::Palette;
+		return singleColorFaces ? MeshType::Palette : options.Meshing.MeshType;
+	}
+
+	// Atlas faces without a border have their uvs moved a tiny bit in, so their edges never sample the neighbor faces.
+	// Faces span several texels, a bigger inset (like half a texel) would squeeze them and move their color boundaries.
+	static f32 GetUVInset(const ConvertOptions& options)
+	{
+		return options.Texturing.TextureType == TextureType::Atlas && !options.Texturing.AtlasBorders ? 1.0f / 64.0f : 0.0f;
+	}
+
+	// Vertex colors replace the textures.
+	static bool ShouldGenerateTextures(const ConvertOptions& options)
+	{
+		return options.Texturing.GenerateTextures && !options.Meshing.VertexColors;
+	}
+
+	// Texture work of a run. Atlas pages are drawn whole as they come, unless the export streams them to the files (see 'ExportOptions::StreamTextures'),
+	// their mips are generated in the background so the next faces (frame, mesh) get packed meanwhile. Wait for them before using the textures.
+	struct TextureTasks
+	{
+		bool StreamPages = false;
+		std::vector<std::future<void>> Mips{};
+	};
+
+	static void StartTextures(const std::vector<std::shared_ptr<TextureData>>& textures, const ConvertOptions& options, TextureTasks& tasks)
+	{
+		// Only atlas faces are aligned to the mips, they are made from whole pages
+		const bool mips = options.Texturing.TextureType == TextureType::Atlas && options.Texturing.AtlasMips > 0;
+
+		for (const auto& texture : textures)
+		{
+			if (texture->Buffer.empty() && texture->DrawRows && (!tasks.StreamPages || mips))
+			{
+				const s32 width = static_cast<s32>(texture->Width);
+				const s32 height = static_cast<s32>(texture->Height);
+				texture->Buffer.resize(size_t(width) * height * 4);
+				texture->DrawRows(0, height, texture->Buffer.data());
+				texture->DrawRows = nullptr;
+			}
+
+			if (mips)
+			{
+				tasks.Mips.push_back(std::async(std::launch::async, [texture, levels = options.Texturing.AtlasMips]()
+				{
+					MipGenerator::GenerateMips(*texture, levels);
+				}));
+			}
+		}
+	}
+
+	static std::vector<std::shared_ptr<TextureData>> GetTextures(std::vector<FaceRect>& faces, const vox_file* voxData, const ConvertOptions& options, TextureTasks& textureTasks)
+	{
+		auto textures = _textureGeneratorFactory->Get(options.Texturing.TextureType)->GetTextures(faces, voxData->palette, voxData->voxModels, options.Texturing);
+		StartTextures(textures, options, textureTasks);
+
+		return textures;
+	}
+
+	static void WaitForMips(TextureTasks& textureTasks)
+	{
+		for (auto& task : textureTasks.Mips)
+		{
+			task.get();
+		}
+
+		textureTasks.Mips.clear();
+	}
+
+	static std::vector<FaceRect> GetModelFaces(const vox_file* voxData, const s32 modelId, const ConvertOptions& options, const MeshedModels* meshedModels)
+	{
+		if (meshedModels && modelId < static_cast<s32>(meshedModels->size()))
+		{
+			return (*meshedModels)[modelId];
+		}
+
+		return _mesherFactory->Get(GetMeshType(options))->CreateFaces(voxData->voxModels[modelId], voxData->sizes[modelId], modelId);
+	}
+
+	// Size the meshes of a model are centered on, downsampled models keep the source one (see 'vox_file::voxelScale').
+	static const vox_size& GetPivotSize(const vox_file* voxData, const s32 modelId)
+	{
+		return voxData->sourceSizes.empty() ? voxData->sizes[modelId] : voxData->sourceSizes[modelId];
+	}
+
+	// Reads the file, when 'PipelinedParsing' is on, every model is sent to a meshing task as soon as it is decoded.
+	static std::shared_ptr<vox_file> ReadVoxFile(const std::string& path, const ConvertOptions& options, MeshedModels& meshedModels)
+	{
+		if (GetMeshType(options) != options.Meshing.MeshType)
+		{
+			LOG_WARN("Palette textures and vertex colors need single colored faces, using the palette mesher.");
+		}
+
+		if (!options.PipelinedParsing)
+		{
+			return VoxParser::read_vox_file(path.c_str());
+		}
+
+		const std::shared_ptr<MesherBase> mesher = _mesherFactory->Get(GetMeshType(options));
+		const size_t maxTasksInFlight = std::max(1u, std::thread::hardware_concurrency());
+
+		std::vector<std::future<std::vector<FaceRect>>> tasks{};
+		size_t collected = 0;
+
+		auto onModelRead = [&](s32 modelIndex, const vox_model& model, const vox_size& size)
+		{
+			// Don't let the reader get too far ahead of the meshers.
+			if (tasks.size() - collected >= maxTasksInFlight)
+			{
+				meshedModels.push_back(tasks[collected++].get());
+			}
+
+			// The model is copied, 'voxModels' can reallocate while the task is running (the grid itself is never moved).
+			tasks.push_back(std::async(std::launch::async, [mesher, model, size, modelIndex]()
+			{
+				return mesher->CreateFaces(model, size, modelIndex);
+			}));
+		};
+
+		std::shared_ptr<vox_file> voxData = VoxParser::read_vox_file(path.c_str(), onModelRead);
+
+		while (collected < tasks.size())
+		{
+			meshedModels.push_back(tasks[collected++].get());
+		}
+
+		LOG_INFO("Pipelined meshing done, models: {0}", meshedModels.size());
+
+		return voxData;
+	}
+
+	// Groups the faces by the atlas page they were packed in, a mesh can only use one texture.
+	// Faces that couldn't be packed anywhere (page -1) are left out.
+	static std::map<s32, std::vector<FaceRect>> SplitFacesByPage(const std::vector<FaceRect>& faces)
+	{
+		std::map<s32, std::vector<FaceRect>> pages{};
+
+		for (const auto& face : faces)
+		{
+			if (face.atlasPage >= 0)
+			{
+				pages[face.atlasPage].push_back(face);
+			}
+		}
+
+		return pages;
+	}
+
+	// Face center in model coordinates, doubled so it stays an integer.
+	static glm::ivec3 GetDoubledFaceCenter(const FaceRect& face)
+	{
+		const s32 u = face.uMin + face.uMax;
+		const s32 v = face.vMin + face.vMax;
+		const s32 c = face.constantCoord * 2;
+
+		switch (face.orientation)
+		{
+		case Orientation::PosX:
+		case Orientation::NegX:
+			return { c, v, u };
+		case Orientation::PosY:
+		case Orientation::NegY:
+			return { u, c, v };
+		default:
+			return { u, v, c };
+		}
+	}
+
+	using BuildMeshFunc = std::function<std::shared_ptr<UnvoxMesh>(const std::vector<FaceRect>&)>;
+
+	// Builds the meshes of some faces. With 'Use16BitIndices', meshes with too many vertices for 16 bit indices are split in halves
+	// along the longest axis of their face centers, so every part stays spatially coherent, until all of them fit.
+	static void BuildMeshes(std::vector<FaceRect> faces, const ConvertOptions& options, const BuildMeshFunc& build, std::vector<std::shared_ptr<UnvoxMesh>>& meshesOut)
+	{
+		auto mesh = build(faces);
+
+		if (options.Meshing.Use16BitIndices && mesh->Indices16.empty() && faces.size() > 1)
+		{
+			glm::ivec3 minCenter(std::numeric_limits<s32>::max());
+			glm::ivec3 maxCenter(std::numeric_limits<s32>::min());
+			for (const auto& face : faces)
+			{
+				const glm::ivec3 center = GetDoubledFaceCenter(face);
+				minCenter = glm::min(minCenter, center);
+				maxCenter = glm::max(maxCenter, center);
+			}
+
+			const glm::ivec3 extent = maxCenter - minCenter;
+			const s32 axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+			const auto middle = faces.begin() + faces.size() / 2;
+			std::nth_element(faces.begin(), middle, faces.end(), [axis](const FaceRect& a, const FaceRect& b)
+			{
+				return GetDoubledFaceCenter(a)[axis] < GetDoubledFaceCenter(b)[axis];
+			});
+
+			mesh = nullptr;
+
+			std::vector<FaceRect> upperFaces(middle, faces.end());
+			faces.erase(middle, faces.end());
+
+			BuildMeshes(std::move(faces), options, build, meshesOut);
+			BuildMeshes(std::move(upperFaces), options, build, meshesOut);
+			return;
+		}
+
+		meshesOut.push_back(mesh);
+	}
+
+	// Every LOD mesh is simplified from its scene mesh, so all of them run in parallel.
+	static void BuildLods(UnvoxScene& scene, const ConvertOptions& options)
+	{
+		const auto& meshes = scene.Meshes;
+
+		scene.Lods.clear();
+
+		// Downsampled LODs are attached once the whole file is converted (see 'BuildVoxelLods')
+		if (options.LodMode != LodType::Simplify)
+		{
+			return;
+		}
+
+		for (size_t i = 0; i < options.Lods.size(); ++i)
+		{
+			if (options.Lods[i] > 0.0f)
+			{
+				UnvoxLod lod{};
+				lod.Level = s32(i) + 1;
+				lod.Factor = std::min(options.Lods[i], 1.0f);
+				lod.Meshes.resize(meshes.size());
+				scene.Lods.push_back(std::move(lod));
+			}
+		}
+
+		std::vector<f32> errors(scene.Lods.size() * meshes.size());
+
+		ParallelFor(errors.size(), 1, [&](size_t i)
+		{
+			UnvoxLod& lod = scene.Lods[i / meshes.size()];
+			const size_t mesh = i % meshes.size();
+			lod.Meshes[mesh] = MeshSimplifier::Simplify(*meshes[mesh], lod.Factor, options.LodMaxError, errors[i]);
+		});
+
+		size_t previousFaces = 0;
+		for (const auto& mesh : meshes)
+		{
+			previousFaces += mesh->GetFaceCount();
+		}
+
+		// 'LodMaxError' can stop the simplifier before the factor is reached, levels that don't get below the previous one would only be copies of it
+		std::vector<UnvoxLod> lods{};
+		for (size_t l = 0; l < scene.Lods.size(); ++l)
+		{
+			UnvoxLod& lod = scene.Lods[l];
+			size_t faces = 0;
+			for (size_t m = 0; m < meshes.size(); ++m)
+			{
+				lod.Error = std::max(lod.Error, errors[l * meshes.size() + m]);
+				faces += lod.Meshes[m]->GetFaceCount();
+			}
+
+			if (faces >= previousFaces)
+			{
+				LOG_INFO("LOD{0}: factor: {1}, faces: {2}, not below the previous level, skipped.", lod.Level, lod.Factor, faces);
+				continue;
+			}
+
+			LOG_INFO("LOD{0}: factor: {1}, faces: {2}, error: {3:.4f}", lod.Level, lod.Factor, faces, lod.Error);
+
+			previousFaces = faces;
+			lods.push_back(std::move(lod));
+		}
+
+		scene.Lods = std::move(lods);
+	}
+
+	// Per mesh stages that run once every mesh of a scene is built, meshes are independent so they are spread over worker threads.
+	static void PostprocessMeshes(UnvoxScene& scene, const ConvertOptions& options)
+	{
+		// LODs are simplified from the float meshes as they were built, then go through the same stages
+		BuildLods(scene, options);
+
+		const auto& meshes = scene.Meshes;
+		const auto allMeshes = scene.GetAllMeshes();
+		std::vector<MeshCacheStats> before(meshes.size());
+		std::vector<MeshCacheStats> after(meshes.size());
+
+		ParallelFor(allMeshes.size(), 1, [&](size_t i)
+		{
+			UnvoxMesh& mesh = *allMeshes[i];
+
+			if (options.Meshing.OptimizeForGPU)
+			{
+				// Stats are about the scene meshes, LOD meshes come after them
+				const bool sceneMesh = i < meshes.size();
+				if (sceneMesh)
+				{
+					before[i] = MeshGpuOptimizer::Analyze(mesh);
+				}
+
+				MeshGpuOptimizer::Optimize(mesh);
+
+				if (sceneMesh)
+				{
+					after[i] = MeshGpuOptimizer::Analyze(mesh);
+				}
+			}
+
+			// Meshlets point to vertices, so they go after the reordering
+			if (options.Meshing.BuildMeshlets)
+			{
+				MeshletBuilder::Build(mesh, options.Meshing.MeshletMaxVertices, options.Meshing.MeshletMaxTriangles);
+			}
+
+			// Last, every other stage works on the float vertices
+			if (options.Meshing.QuantizeVertices)
+			{
+				VertexQuantizer::Quantize(mesh);
+			}
+		});
+
+		if (options.Meshing.OptimizeForGPU && !meshes.empty())
+		{
+			// Averages over all the triangles (ACMR) and vertices (ATVR) of the scene
+			f64 triangles = 0.0, vertices = 0.0;
+			f64 acmrBefore = 0.0, acmrAfter = 0.0, atvrBefore = 0.0, atvrAfter = 0.0;
+			for (size_t i = 0; i < meshes.size(); ++i)
+			{
+				const f64 meshTriangles = f64(meshes[i]->GetFaceCount());
+				const f64 meshVertices = f64(meshes[i]->Vertices.size() + meshes[i]->Quantized.GetVertexCount());
+
+				acmrBefore += before[i].ACMR * meshTriangles;
+				acmrAfter += after[i].ACMR * meshTriangles;
+				atvrBefore += before[i].ATVR * meshVertices;
+				atvrAfter += after[i].ATVR * meshVertices;
+				triangles += meshTriangles;
+				vertices += meshVertices;
+			}
+
+			triangles = std::max(triangles, 1.0);
+			vertices = std::max(vertices, 1.0);
+			scene.CacheStatsBefore = { f32(acmrBefore / triangles), f32(atvrBefore / vertices) };
+			scene.CacheStatsAfter = { f32(acmrAfter / triangles), f32(atvrAfter / vertices) };
+
+			LOG_INFO("GPU optimized meshes: {0}, ACMR: {1:.3f} -> {2:.3f}, ATVR: {3:.3f} -> {4:.3f}", meshes.size(),
+					 scene.CacheStatsBefore.ACMR, scene.CacheStatsAfter.ACMR, scene.CacheStatsBefore.ATVR, scene.CacheStatsAfter.ATVR);
+		}
+	}
+
+	// Model a shape shows in a frame, shapes with a single model show it in every frame. -1 if the shape is hidden in the frame.
+	static s32 GetShapeModelId(const vox_nSHP& shape, const s32 frameIndex)
+	{
+		if (shape.models.size() == 1)
+		{
+			return shape.models[0].modelID;
+		}
+
+		for (const auto& m : shape.models)
+		{
+			if (m.frameIndex == frameIndex)
+			{
+				return m.modelID;
+			}
+		}
+
+		return -1;
+	}
+
+	// Atlas shared by several scenes: every frame of a file (see 'TexturingOptions::SharedFramesAtlas') or every file of a batch,
+	// with the packed faces of every model the scenes show.
+	struct SharedAtlas
+	{
+		std::vector<std::shared_ptr<TextureData>> Textures;
+		std::unordered_map<s32, std::vector<FaceRect>> ModelsFaces;
+	};
+
+	static s32 GetFrameCount(const vox_file* voxData)
+	{
+		s32 frameCount = 0;
+
+		// find any transform with framesCount > 1
+		for (auto& kv : voxData->transforms)
+		{
+			frameCount = std::max(frameCount, kv.second.framesCount);
+		}
+
+		return frameCount;
+	}
+
+	// Every frame gets its own scene (see 'GetModels'), otherwise there is one scene with a node per model.
+	static bool HasFrameScenes(const vox_file* voxData, const ConvertOptions& options)
+	{
+		return options.ExportFramesSeparatelly && GetFrameCount(voxData) >= 1 && voxData->shapes.size() > 0;
+	}
+
+	// Models 'Run' makes meshes of, with frame scenes only the ones some frame shows.
+	static std::vector<s32> GetSceneModelIds(const vox_file* voxData, const ConvertOptions& options)
+	{
+		std::vector<bool> shownModels(voxData->voxModels.size(), !HasFrameScenes(voxData, options));
+
+		const s32 frameCount = GetFrameCount(voxData);
+		for (s32 fi = 0; fi < frameCount; ++fi)
+		{
+			for (const auto& shpKV : voxData->shapes)
+			{
+				const s32 modelId = GetShapeModelId(shpKV.second, fi);
+
+				if (modelId >= 0 && modelId < static_cast<s32>(shownModels.size()))
+				{
+					shownModels[modelId] = true;
+				}
+			}
+		}
+
+		std::vector<s32> modelIds{};
+		for (size_t modelId = 0; modelId < shownModels.size(); ++modelId)
+		{
+			if (shownModels[modelId])
+			{
+				modelIds.push_back(static_cast<s32>(modelId));
+			}
+		}
+
+		return modelIds;
+	}
+
+	static std::vector<FaceRect> GetSceneFaces(const vox_file* voxData, const ConvertOptions& options, const MeshedModels* meshedModels)
+	{
+		std::vector<FaceRect> faces{};
+		for (const s32 modelId : GetSceneModelIds(voxData, options))
+		{
+			const std::vector<FaceRect> modelFaces = GetModelFaces(voxData, modelId, options, meshedModels);
+			faces.insert(faces.end(), modelFaces.begin(), modelFaces.end());
+		}
+
+		return faces;
+	}
+
+	static void SetSharedAtlasFaces(const std::vector<FaceRect>& faces, SharedAtlas& atlas)
 	{
-		// Use stb_image_write to write PNG
-		if (stbi_write_png(filename.c_str(), width, height, 4, rgbaData.data(), width * 4) == 0) {
-			return false;
+		for (const auto& face : faces)
+		{
+			atlas.ModelsFaces[face.modelIndex].push_back(face);
 		}
-		return true;
 	}
 
+	// Models shown in several frames are packed once, the atlas generator also merges identical faces across models.
+	static SharedAtlas GetFramesAtlas(const vox_file* voxData, const ConvertOptions& options, const MeshedModels* meshedModels, TextureTasks& textureTasks)
+	{
+		std::vector<FaceRect> faces = GetSceneFaces(voxData, options, meshedModels);
+
+		SharedAtlas atlas{};
+		atlas.Textures = GetTextures(faces, voxData, options, textureTasks);
+		SetSharedAtlasFaces(faces, atlas);
 
+		LOG_INFO("Frames atlas, frames: {0}, models: {1}, pages: {2}", GetFrameCount(voxData), atlas.ModelsFaces.size(), atlas.Textures.size());
+
+		return atlas;
+	}
 
 	// TODO: start simple, from the begining, the whole code base has a problem of code duplication.
-	static std::shared_ptr<UnvoxScene> GetModels(const vox_file* voxData, const s32 frameIndex, const ConvertOptions& options)
+	static std::shared_ptr<UnvoxScene> GetModels(const vox_file* voxData, const s32 frameIndex, const ConvertOptions& options, const MeshedModels* meshedModels, TextureTasks& textureTasks,
+												 const SharedAtlas* sharedAtlas)
 	{
 		struct MeshWrapData
 		{
@@ -164,7 +633,10 @@ namespace Unvoxeller
 			}
 
 			std::vector<color> pallete = voxData->palette;
-			std::shared_ptr<TextureData> textureData = nullptr;
+
+			// Atlas pages the current faces were packed in, and the scene index of the first one.
+			std::vector<std::shared_ptr<TextureData>> textures{};
+			s32 firstTextureIndex = 0;
 
 
 
@@ -175,36 +647,28 @@ namespace Unvoxeller
 			std::unordered_map<s32, std::vector<FaceRect>> modelsData = {};
 
 
-			if (!options.Texturing.SeparateTexturesPerMesh)
+			// The shared atlas already has every model packed
+			const bool texturesPerMesh = !sharedAtlas && options.Texturing.SeparateTexturesPerMesh;
+
+			if (sharedAtlas)
+			{
+				textures = sharedAtlas->Textures;
+				scene->Textures = textures;
+			}
+			else if (!texturesPerMesh)
 			{
 				for (auto& shpKV : voxData->shapes)
 				{
 					const vox_nSHP& shape = shpKV.second;
 
-					int modelId = -1;
-
-					if (shape.models.size() == 1)
-					{
-						modelId = shape.models[0].modelID;
-					}
-					else
-					{
-						for (const auto& m : shape.models)
-						{
-							if (m.frameIndex == frameIndex)
-							{
-								modelId = m.modelID;
-								break;
-							}
-						}
-					}
+					const s32 modelId = GetShapeModelId(shape, frameIndex);
 
 					if (modelId < 0)
 					{
 						continue;
 					}
 
-					faces = _mesherFactory->Get(options.Meshing.MeshType)->CreateFaces(voxData->voxModels[modelId], voxData->sizes[modelId], modelId);
+					faces = GetModelFaces(voxData, modelId, options, meshedModels);
 
 					// --- Below
 
@@ -212,15 +676,10 @@ namespace Unvoxeller
 					mergedFaces.insert(mergedFaces.end(), faces.begin(), faces.end());
 				}
 
-				if (options.Texturing.GenerateTextures)
+				if (ShouldGenerateTextures(options))
 				{
-					textureData = _textureGeneratorFactory->Get(options.Texturing.TextureType)->GetTexture(mergedFaces, voxData->palette, voxData->voxModels, options.Texturing.TexturesPOT);
-					scene->Textures.push_back(textureData);
-
-				}
-				else
-				{
-					textureData = nullptr;
+					textures = GetTextures(mergedFaces, voxData, options, textureTasks);
+					scene->Textures.insert(scene->Textures.end(), textures.begin(), textures.end());
 				}
 
 				// Very slow
@@ -248,23 +707,7 @@ namespace Unvoxeller
 
 				const vox_nSHP& shape = shpKV.second;
 
-				int modelId = -1;
-
-				if (shape.models.size() == 1)
-				{
-					modelId = shape.models[0].modelID;
-				}
-				else
-				{
-					for (const auto& m : shape.models)
-					{
-						if (m.frameIndex == frameIndex)
-						{
-							modelId = m.modelID;
-							break;
-						}
-					}
-				}
+				const s32 modelId = GetShapeModelId(shape, frameIndex);
 
 				if (modelId < 0)
 				{
@@ -275,17 +718,15 @@ namespace Unvoxeller
 
 				// Generate mesh for this shape/model
 
-				if (options.Texturing.SeparateTexturesPerMesh)
+				if (texturesPerMesh)
 				{
-					faces = _mesherFactory->Get(options.Meshing.MeshType)->CreateFaces(voxData->voxModels[modelId], voxData->sizes[modelId], modelId);
+					faces = GetModelFaces(voxData, modelId, options, meshedModels);
+					firstTextureIndex = static_cast<s32>(scene->Textures.size());
 
-					if (options.Texturing.GenerateTextures)
-					{
-						textureData = _textureGeneratorFactory->Get(options.Texturing.TextureType)->GetTexture(faces, voxData->palette, voxData->voxModels, options.Texturing.TexturesPOT);
-					}
-					else
+					if (ShouldGenerateTextures(options))
 					{
-						textureData = nullptr;
+						textures = GetTextures(faces, voxData, options, textureTasks);
+						scene->Textures.insert(scene->Textures.end(), textures.begin(), textures.end());
 					}
 					// Remove this from here
 					// if (options.Texturing.GenerateTextures)
@@ -293,13 +734,12 @@ namespace Unvoxeller
 					// 	imageName = baseName + "_frame" + std::to_string(shapeIndex++) + ".png";
 					// 	SaveAtlasImage(imageName, textureData->Width, textureData->Height, textureData->Buffer);
 					// }
-
-					scene->Textures.push_back(textureData);
-
 				}
 				else
 				{
-					faces = modelsData[modelId];
+					const auto& packedFaces = sharedAtlas ? sharedAtlas->ModelsFaces : modelsData;
+					const auto found = packedFaces.find(modelId);
+					faces = found != packedFaces.end() ? found->second : std::vector<FaceRect>{};
 				}
 
 
@@ -320,51 +760,69 @@ namespace Unvoxeller
 				// If you want to support groups (nGRP), you may have to walk up to the root and find the chain.
 				vox_transform wxf = AccumulateWorldTransform(shape.nodeID, frameIndex, *voxData);
 
-				// Build mesh and apply MagicaVoxel rotation+translation directly into vertices:
-				auto mesh = MeshBuilder::BuildMeshFromFaces(
-					faces,
-					textureData->Width, textureData->Height,
-					options.Meshing.FlatShading,
-					pallete,
-					box,          // pivot centering
-					voxData->sizes[modelId],
-					wxf.rot,     // MagicaVoxel 3×3 rotation
-					wxf.trans    // MagicaVoxel translation,
-				);
-
-
-				// 3) Recenter every vertex so that the mesh’s center is at the origin
-				// for (unsigned int i = 0; i < mesh->Vertices.size(); ++i)
-				// //	{
-				// 		mesh->Vertices[i] -= glm::vec3(10.5, 10.5, 10.5);
-				// //	}
-				
-				// Assign material index...
-
-				if (options.Meshing.GenerateMaterials)
-				{
-					mesh->MaterialIndex = options.Meshing.MaterialPerMesh && !options.ExportMeshesSeparatelly ? materialIndex++ : 0;
-				}
-				else
-				{
-					mesh->MaterialIndex = 0;
-				}
-				// Record mesh index and create node with identity transform:
-				unsigned int meshIndex = static_cast<unsigned int>(meshes.size());
-
 				auto node = std::make_shared<UnvoxNode>();
 				node->Name = name;
 
-				if (options.ExportMeshesSeparatelly)
+				// One mesh per atlas page, so every mesh samples a single texture.
+				for (const auto& [page, pageFaces] : SplitFacesByPage(faces))
 				{
-					node->MeshesIndexes.push_back(0);
-				}
-				else
-				{
-					node->MeshesIndexes.push_back(meshIndex);
+					const std::shared_ptr<TextureData> textureData = page < static_cast<s32>(textures.size()) ? textures[page] : nullptr;
+
+					// Build mesh and apply MagicaVoxel rotation+translation directly into vertices:
+					std::vector<std::shared_ptr<UnvoxMesh>> pageMeshes{};
+					BuildMeshes(pageFaces, options, [&](const std::vector<FaceRect>& meshFaces)
+					{
+						return MeshBuilder::BuildMeshFromFaces(
+							meshFaces,
+							textureData ? textureData->Width : 0, textureData ? textureData->Height : 0,
+							pallete,
+							box,          // pivot centering
+							GetPivotSize(voxData, modelId),
+							wxf.rot,     // MagicaVoxel 3×3 rotation
+							wxf.trans,   // MagicaVoxel translation,
+							options.Meshing.VertexColors,
+							options.Meshing.VertexPaletteIndices,
+							GetUVInset(options),
+							options.Meshing.Use16BitIndices,
+							voxData->voxelScale
+						);
+					}, pageMeshes);
+
+					for (const auto& mesh : pageMeshes)
+					{
+
+						// 3) Recenter every vertex so that the mesh’s center is at the origin
+						// for (unsigned int i = 0; i < mesh->Vertices.size(); ++i)
+						// //	{
+						// 		mesh->Vertices[i] -= glm::vec3(10.5, 10.5, 10.5);
+						// //	}
+						
+						// Assign material index...
+
+						if (options.Meshing.GenerateMaterials)
+						{
+							mesh->MaterialIndex = options.Meshing.MaterialPerMesh && !options.ExportMeshesSeparatelly ? materialIndex++ : 0;
+						}
+						else
+						{
+							mesh->MaterialIndex = 0;
+						}
+						// Record mesh index and create node with identity transform:
+						unsigned int meshIndex = static_cast<unsigned int>(meshes.size());
+
+						if (options.ExportMeshesSeparatelly)
+						{
+							node->MeshesIndexes.push_back(0);
+						}
+						else
+						{
+							node->MeshesIndexes.push_back(meshIndex);
+						}
+
+						meshes.push_back({ mesh, textureData ? firstTextureIndex + page : 0 });
+					}
 				}
 
-				meshes.push_back({ mesh, shapeIndex });
 				shapeNodes.push_back(node);
 			}
 		}
@@ -421,7 +879,7 @@ namespace Unvoxeller
 
 				auto mat = std::make_shared<UnvoxMaterial>();
 				//mat->Name =  meshes[i].textureIndex;
-				mat->TextureIndex = std::min(i, scene->Textures.size()-1);
+				mat->TextureIndex = meshes[i].textureIndex;
 
 				scene->Materials[matIndex] = mat;
 			}
@@ -453,10 +911,16 @@ namespace Unvoxeller
 			}
 		}
 
+		PostprocessMeshes(*scene, options);
+
 		return scene;
 	}
 
-	const std::vector<std::shared_ptr<UnvoxScene>> Run(const vox_file* voxData, const ConvertOptions& options)
+	static void BuildVoxelLods(const vox_file* voxData, const ConvertOptions& options, const std::vector<std::shared_ptr<UnvoxScene>>& scenes);
+
+	// With 'streamPages' atlas pages keep drawing from 'voxData' (see 'ExportOptions::StreamTextures'), so it has to outlive the scenes textures.
+	const std::vector<std::shared_ptr<UnvoxScene>> Run(const vox_file* voxData, const ConvertOptions& options, const MeshedModels* meshedModels = nullptr,
+															 const SharedAtlas* sharedAtlas = nullptr, bool streamPages = false)
 	{
 		if (!voxData || !voxData->isValid)
 		{
@@ -465,13 +929,7 @@ namespace Unvoxeller
 		}
 
 		// Determine if we have multiple frames (multiple models or transform frames)
-		s32 frameCount = 0;
-
-		// find any transform with framesCount > 1
-		for (auto& kv : voxData->transforms)
-		{
-			frameCount = std::max(frameCount, kv.second.framesCount);
-		}
+		const s32 frameCount = GetFrameCount(voxData);
 
 		LOG_INFO("Version: {0}", voxData->header.version);
 		LOG_INFO("Transforms: {0}", voxData->transforms.size());
@@ -485,19 +943,31 @@ namespace Unvoxeller
 			return {};
 		}
 
-		if (options.ExportFramesSeparatelly && frameCount >= 1 && voxData->shapes.size() > 0)
+		if (HasFrameScenes(voxData, options))
 		{
 			std::vector<std::shared_ptr<UnvoxScene>> scenesOut{};
+			TextureTasks textureTasks{ streamPages };
+
+			std::unique_ptr<SharedAtlas> framesAtlas = nullptr;
+			if (!sharedAtlas && options.Texturing.SharedFramesAtlas && ShouldGenerateTextures(options))
+			{
+				framesAtlas = std::make_unique<SharedAtlas>(GetFramesAtlas(voxData, options, meshedModels, textureTasks));
+				sharedAtlas = framesAtlas.get();
+			}
 
 			for (s32 fi = 0; fi < frameCount; ++fi)
 			{
 				// Prepare a new minimal scene for this frame
 				LOG_INFO("Frame processing: {0}", fi);
-				auto scene = GetModels(voxData, fi, options);
+				auto scene = GetModels(voxData, fi, options, meshedModels, textureTasks, sharedAtlas);
 
 				scenesOut.push_back(scene);
 			}
 
+			WaitForMips(textureTasks);
+
+			BuildVoxelLods(voxData, options, scenesOut);
+
 			return scenesOut;
 		}
 		else
@@ -508,100 +978,330 @@ namespace Unvoxeller
 			scene->RootNode = std::make_shared<UnvoxNode>();
 
 			scene->RootNode->Children.resize(meshCount);
-			scene->Meshes.resize(meshCount);
-			scene->Materials.resize((unsigned int)(options.Texturing.SeparateTexturesPerMesh ? meshCount : 1));
 
-			std::vector<FaceRect> allFaces{};
+			TextureTasks textureTasks{ streamPages };
 
-			if (options.Texturing.SeparateTexturesPerMesh)
+			if (sharedAtlas)
 			{
-				
+				scene->Textures = sharedAtlas->Textures;
 			}
-			else 
-			{
-				// If one atlas for all, gather all faces first
-				for (size_t i = 0; i < meshCount; ++i)
-				{
-					std::vector<FaceRect> faces = _mesherFactory->Get(options.Meshing.MeshType)->CreateFaces(voxData->voxModels[i], voxData->sizes[i], i);
-					// Tag faces with an offset or id if needed (not needed for atlas, we just combine)
-					allFaces.insert(allFaces.end(), faces.begin(), faces.end());
-				}
-			}
-
 
-			LOG_INFO("TODO: Atlas saved");
-
-			// Assign this texture to the single material
-			//aiString texPath(atlasName);
-			auto oMat = std::make_shared<UnvoxMaterial>();
-			//oMat->Name = atlasName;
-			oMat->TextureIndex = 0;
-			scene->Materials[0] = oMat;
-
-			size_t faceOffset = 0;
 			for (size_t i = 0; i < meshCount; ++i)
 			{
 				// Remesh the frame to get number of faces:            
-				std::vector<FaceRect> frameFaces = _mesherFactory->Get(options.Meshing.MeshType)->CreateFaces(voxData->voxModels[i], voxData->sizes[i], i);
+				std::vector<FaceRect> frameFaces{};
+
+				std::vector<std::shared_ptr<TextureData>> textures{};
+				s32 firstTextureIndex = 0;
+
+				if (sharedAtlas)
+				{
+					const auto found = sharedAtlas->ModelsFaces.find(static_cast<s32>(i));
+					frameFaces = found != sharedAtlas->ModelsFaces.end() ? found->second : std::vector<FaceRect>{};
+					textures = sharedAtlas->Textures;
+				}
+				else
+				{
+					frameFaces = GetModelFaces(voxData, static_cast<s32>(i), options, meshedModels);
+
+					if (ShouldGenerateTextures(options))
+					{
+						textures = GetTextures(frameFaces, voxData, options, textureTasks);
+					}
 
-				const auto texData = _textureGeneratorFactory->Get(options.Texturing.TextureType)->GetTexture(frameFaces, voxData->palette, voxData->voxModels, options.Texturing.TexturesPOT);
+					firstTextureIndex = static_cast<s32>(scene->Textures.size());
+					scene->Textures.insert(scene->Textures.end(), textures.begin(), textures.end());
+				}
 
-				auto& sz = voxData->sizes[i];
 				auto& mdl = voxData->voxModels[i];
 				auto& box = mdl.boundingBox;
 
-				auto mesh = MeshBuilder::BuildMeshFromFaces(frameFaces, texData->Width, texData->Height, options.Meshing.FlatShading, voxData->palette, box, sz);
-				mesh->MaterialIndex = options.Texturing.SeparateTexturesPerMesh ? (int)i : 0;
-
 				// Create node for this mesh
 				auto node = std::make_shared<UnvoxNode>();
 				node->Name = "Frame" + std::to_string(i);
-				node->MeshesIndexes = { static_cast<s32>(i) };
+
+				// Every model has its own atlas here, one mesh and material per atlas page.
+				for (const auto& [page, pageFaces] : SplitFacesByPage(frameFaces))
+				{
+					const std::shared_ptr<TextureData> texData = page < static_cast<s32>(textures.size()) ? textures[page] : nullptr;
+
+					std::vector<std::shared_ptr<UnvoxMesh>> pageMeshes{};
+					BuildMeshes(pageFaces, options, [&](const std::vector<FaceRect>& meshFaces)
+					{
+						return MeshBuilder::BuildMeshFromFaces(meshFaces, texData ? texData->Width : 0, texData ? texData->Height : 0, voxData->palette,
+															   box, GetPivotSize(voxData, static_cast<s32>(i)), glm::mat3(1.0f), glm::vec3(0.0f), options.Meshing.VertexColors,
+															   options.Meshing.VertexPaletteIndices, GetUVInset(options), options.Meshing.Use16BitIndices, voxData->voxelScale);
+					}, pageMeshes);
+
+					for (const auto& mesh : pageMeshes)
+					{
+						auto oMat = std::make_shared<UnvoxMaterial>();
+						oMat->TextureIndex = texData ? firstTextureIndex + page : 0;
+
+						mesh->MaterialIndex = static_cast<s32>(scene->Materials.size());
+						scene->Materials.push_back(oMat);
+
+						node->MeshesIndexes.push_back(static_cast<s32>(scene->Meshes.size()));
+						scene->Meshes.push_back(mesh);
+					}
+				}
 
 				scene->RootNode->Children[i] = node;
-				scene->Meshes[i] = mesh;
-				scene->Textures.push_back(texData);
 
 				LOG_INFO("Completed mesh: {0}", i);
 			}
 
+			PostprocessMeshes(*scene, options);
+
+			WaitForMips(textureTasks);
+
+			BuildVoxelLods(voxData, options, { scene });
+
 			return { scene };
 		}
 
 		return {};
 	}
+
+	// Adds the meshes of 'lodScene' to 'scene' as a LOD, with its materials and textures after the scene ones.
+	static void AttachLod(UnvoxScene& scene, const UnvoxScene& lodScene, UnvoxLod lod)
+	{
+		const s32 firstTexture = static_cast<s32>(scene.Textures.size());
+		const s32 firstMaterial = static_cast<s32>(scene.Materials.size());
+
+		scene.Textures.insert(scene.Textures.end(), lodScene.Textures.begin(), lodScene.Textures.end());
+
+		for (const auto& material : lodScene.Materials)
+		{
+			auto lodMaterial = std::make_shared<UnvoxMaterial>(*material);
+			lodMaterial->TextureIndex += firstTexture;
+			scene.Materials.push_back(lodMaterial);
+		}
+
+		for (const auto& mesh : lodScene.Meshes)
+		{
+			mesh->MaterialIndex += firstMaterial;
+			lod.Meshes.push_back(mesh);
+		}
+
+		scene.Lods.push_back(std::move(lod));
+	}
+
+	// Downsampled LODs (see 'LodType::Downsample'): the models are downsampled once per level, each level from the previous one,
+	// then every level is meshed and textured like the source file, in parallel.
+	static void BuildVoxelLods(const vox_file* voxData, const ConvertOptions& options, const std::vector<std::shared_ptr<UnvoxScene>>& scenes)
+	{
+		if (options.LodMode != LodType::Downsample || scenes.empty())
+		{
+			return;
+		}
+
+		std::vector<s32> levels{};
+		for (size_t i = 0; i < options.Lods.size(); ++i)
+		{
+			if (options.Lods[i] > 0.0f)
+			{
+				levels.push_back(s32(i) + 1);
+			}
+		}
+
+		if (levels.empty())
+		{
+			return;
+		}
+
+		const auto mips = VoxelDownsampler::BuildPyramid(*voxData, levels.back(), options.LodVoxelFill);
+
+		// Levels don't have LODs of their own, and their pages are drawn right away (not streamed) since the mips don't outlive this.
+		ConvertOptions lodOptions = options;
+		lodOptions.Lods.clear();
+
+		std::vector<std::vector<std::shared_ptr<UnvoxScene>>> levelScenes(levels.size());
+		ParallelFor(levels.size(), 1, [&](size_t i)
+		{
+			levelScenes[i] = Run(mips[levels[i] - 1]->Data.get(), lodOptions);
+		});
+
+		// Error is a LOD voxel relative to the largest model
+		s32 maxSize = 1;
+		for (const auto& size : voxData->sizes)
+		{
+			maxSize = std::max({ maxSize, size.x, size.y, size.z });
+		}
+
+		for (size_t l = 0; l < levels.size(); ++l)
+		{
+			if (levelScenes[l].size() != scenes.size())
+			{
+				LOG_WARN("LOD{0}: downsampled scenes don't match the source ones, skipped.", levels[l]);
+				continue;
+			}
+
+			size_t faces = 0;
+			for (size_t s = 0; s < scenes.size(); ++s)
+			{
+				UnvoxLod lod{};
+				lod.Level = levels[l];
+				lod.Factor = options.Lods[levels[l] - 1];
+				lod.Error = f32(1 << levels[l]) / f32(maxSize);
+
+				for (const auto& mesh : levelScenes[l][s]->Meshes)
+				{
+					faces += mesh->GetFaceCount();
+				}
+
+				AttachLod(*scenes[s], *levelScenes[l][s], std::move(lod));
+			}
+
+			LOG_INFO("LOD{0}: downsampled: {1}x, faces: {2}", levels[l], 1 << levels[l], faces);
+		}
+	}
 	
-	void VoxellerInit()
+	// Converts every file with one atlas for all of them, the scenes of a file are at its index (empty if it couldn't be read).
+	// 'voxFiles' gets the read files, streamed atlas pages ('streamPages') draw from them. 'batchTextures' gets the shared pages, scenes can have
+	// LOD pages of their own after them.
+	static std::vector<std::vector<std::shared_ptr<UnvoxScene>>> RunBatch(const std::vector<std::string>& paths, const ConvertOptions& batchOptions,
+																		   std::vector<std::shared_ptr<vox_file>>& voxFiles, bool streamPages = false,
+																		   std::vector<std::shared_ptr<TextureData>>* batchTextures = nullptr)
 	{
-		VoxellerApp::init();
+		ConvertOptions options = batchOptions;
+		if (ShouldGenerateTextures(options) && options.Texturing.TextureType != TextureType::Atlas)
+		{
+			LOG_WARN("Only atlas textures can be shared by several files, using an atlas.");
+			options.Texturing.TextureType = TextureType::Atlas;
+		}
+
+		std::vector<MeshedModels> meshedModels(paths.size());
+		voxFiles.assign(paths.size(), nullptr);
+		for (size_t f = 0; f < paths.size(); ++f)
+		{
+			voxFiles[f] = ReadVoxFile(paths[f], options, meshedModels[f]);
+		}
+
+		std::vector<SharedAtlas> atlases(paths.size());
+		TextureTasks textureTasks{ streamPages };
+
+		if (ShouldGenerateTextures(options))
+		{
+			std::vector<std::vector<FaceRect>> filesFaces(paths.size());
+			std::vector<TextureBatchFile> batchFiles{};
+
+			for (size_t f = 0; f < paths.size(); ++f)
+			{
+				if (voxFiles[f] && voxFiles[f]->isValid)
+				{
+					filesFaces[f] = GetSceneFaces(voxFiles[f].get(), options, &meshedModels[f]);
+					batchFiles.push_back({ &filesFaces[f], &voxFiles[f]->palette, &voxFiles[f]->voxModels });
+				}
+			}
+
+			const auto textures = _textureGeneratorFactory->Get(TextureType::Atlas)->GetBatchTextures(batchFiles, options.Texturing);
+			StartTextures(textures, options, textureTasks);
+
+			for (size_t f = 0; f < paths.size(); ++f)
+			{
+				atlases[f].Textures = textures;
+				SetSharedAtlasFaces(filesFaces[f], atlases[f]);
+			}
+
+			if (batchTextures)
+			{
+				*batchTextures = textures;
+			}
+
+			LOG_INFO("Batch atlas, files: {0}, pages: {1}", batchFiles.size(), textures.size());
+		}
+
+		std::vector<std::vector<std::shared_ptr<UnvoxScene>>> filesScenes(paths.size());
+		for (size_t f = 0; f < paths.size(); ++f)
+		{
+			filesScenes[f] = Run(voxFiles[f].get(), options, &meshedModels[f], ShouldGenerateTextures(options) ? &atlases[f] : nullptr);
+		}
+
+		WaitForMips(textureTasks);
+
+		return filesScenes;
 	}
 
-	ExportResults Unvoxeller::ExportVoxToModel(const ExportOptions& eOptions, const ConvertOptions& cOptions)
+	// Saves the texture in the output dir as 'name' plus the format extension, materials point to it by its name.
+	static void SaveTexture(TextureData& texture, const std::string& name, const ExportOptions& eOptions)
 	{
-		if(eOptions.InputPath.empty())
+		texture.Name = name;
+		const std::string imageName = name + GetTextureFileExtension(eOptions.TexturesFormat);
+
+		const std::string imagePath = eOptions.OutputDir + "/" + imageName;
+		const s32 width = s32(texture.Width);
+		const s32 height = s32(texture.Height);
+
+		// Streamed pages (see 'ExportOptions::StreamTextures'): pngs are written a band at a time, block compression needs the whole page for the mips.
+		const bool streamed = texture.Buffer.empty() && texture.DrawRows;
+		bool saved = false;
+
+		if (IsBlockCompressed(eOptions.TexturesFormat))
 		{
-			LOG_ERROR("Path is empty");
+			std::vector<u8> page{};
+			if (streamed)
+			{
+				page.resize(size_t(width) * height * 4);
+				texture.DrawRows(0, height, page.data());
+			}
 
-			return { ConvertMSG::ERROR_EMPTY_PATH };
+			saved = KtxWriter::Write(imagePath, streamed ? page.data() : texture.Buffer.data(), width, height, texture.Mips, eOptions.TexturesFormat, eOptions.TextureMips);
+		}
+		else
+		{
+			saved = streamed ? PngWriter::WriteRows(imagePath, width, height, eOptions.PngCompressionLevel, texture.DrawRows)
+							 : PngWriter::Write(imagePath, texture.Buffer.data(), width, height, eOptions.PngCompressionLevel);
 		}
 
-		std::shared_ptr<vox_file> voxData = VoxParser::read_vox_file(eOptions.InputPath.c_str());
-		const auto scenes = Run(voxData.get(), cOptions);
+		if (!saved)
+		{
+			LOG_ERROR("Can't save texture: {0}", imageName);
+		}
+	}
+
+	// Saves the textures of the scenes and writes the model files.
+	static ExportResults ExportScenes(const std::vector<std::shared_ptr<UnvoxScene>>& scenes, const ExportOptions& eOptions, const ConvertOptions& cOptions,
+									  std::unordered_set<const TextureData*>& savedTextures)
+	{
+		if (IsBlockCompressed(eOptions.TexturesFormat) && (eOptions.OutputFormat == ModelFormat::GLTF || eOptions.OutputFormat == ModelFormat::GLB))
+		{
+			LOG_WARN("Gltf files will reference .ktx2 textures without the 'KHR_texture_basisu' extension, some viewers won't load them.");
+		}
 
 		ExportResults results{};
-		std::string imageName = "";
 
 		LOG_INFO("About to save texture: {0}", eOptions.OutputName);
 
+		// Textures in several scenes (see 'SharedFramesAtlas') are saved once, named after the output instead of a scene.
+		// Textures already in 'savedTextures' are skipped (ex: the shared pages of a batch).
+		std::unordered_map<const TextureData*, s32> textureScenes{};
 		for (const auto& scene : scenes)
 		{
+			for (const auto& textureData : scene->Textures)
+			{
+				textureScenes[textureData.get()]++;
+			}
+		}
+
+		for (size_t s = 0; s < scenes.size(); s++)
+		{
+			const auto& scene = scenes[s];
 			const bool isMultiTexture = scene->Textures.size() > 1;
 
+			// Same naming the model files get, so every scene keeps its own textures.
+			const std::string sceneName = eOptions.OutputName + (scenes.size() > 1 ? "_" + std::to_string(s) : "");
+
 			for (size_t i = 0; i < scene->Textures.size(); i++)
 			{
 				const auto& textureData = scene->Textures[i];
-				imageName = eOptions.OutputName + (isMultiTexture ? "_" + std::to_string(i) : "") + ".png";
-				SaveAtlasImage(eOptions.OutputDir + "/" + imageName, textureData->Width, textureData->Height, textureData->Buffer);
+				if (!savedTextures.insert(textureData.get()).second)
+				{
+					continue;
+				}
+
+				const bool shared = textureScenes[textureData.get()] > 1;
+				SaveTexture(*textureData, (shared ? eOptions.OutputName : sceneName) + (isMultiTexture ? "_" + std::to_string(i) : ""), eOptions);
 			}
 		}	
 		
@@ -625,18 +1325,33 @@ namespace Unvoxeller
 		{
 			LOG_INFO("TJuntctions: {0}", cOptions.Meshing.RemoveTJunctions);
 
-			// TODO: This makes the algorithm freeze when a vox has multiple frames, and is exported as no separated
+			// Meshes are cleaned up independently, every mesh of every scene is spread over worker threads.
+			// Only a single mesh splits its own T-junction search over them, so threads don't nest.
 			if (cOptions.Meshing.RemoveTJunctions)
 			{
-				for (unsigned int m = 0; m < scenes.size(); ++m)
+				std::vector<std::shared_ptr<UnvoxMesh>> meshes{};
+				for (const auto& scene : scenes)
+				{
+					const auto sceneMeshes = scene->GetAllMeshes();
+					meshes.insert(meshes.end(), sceneMeshes.begin(), sceneMeshes.end());
+				}
+
+				ParallelFor(meshes.size(), 1, [&](size_t i)
 				{
-					for (auto& mesh : scenes[m]->Meshes)
+					UnvoxMesh& mesh = *meshes[i];
+
+					// OpenMesh works on the float vertices
+					VertexQuantizer::Dequantize(mesh);
+					CleanUpMesh(&mesh, meshes.size() == 1);
+
+					// The clean up rebuilds the faces
+					if (cOptions.Meshing.BuildMeshlets)
 					{
-						CleanUpMesh(mesh.get());
+						MeshletBuilder::Build(mesh, cOptions.Meshing.MeshletMaxVertices, cOptions.Meshing.MeshletMaxTriangles);
 					}
+				});
 
-					LOG_INFO("Done cleaning up meshes count: {0}", scenes[m]->Meshes.size());
-				}
+				LOG_INFO("Done cleaning up meshes count: {0}", meshes.size());
 			}
 
 			// TODO: fix assimp exporter
@@ -645,6 +1360,19 @@ namespace Unvoxeller
 				results.Msg = ConvertMSG::SUCESS;
 			}
 
+			// Named like the model files
+			if (cOptions.Meshing.BuildMeshlets && !cOptions.ExportMeshesSeparatelly)
+			{
+				for (size_t s = 0; s < scenes.size(); s++)
+				{
+					const std::string meshletsName = eOptions.OutputName + (scenes.size() > 1 ? "_" + std::to_string(s) : "") + ".meshlets";
+					if (!MeshletWriter::Write(eOptions.OutputDir + "/" + meshletsName, scenes[s]->GetAllMeshes()))
+					{
+						LOG_ERROR("Can't save meshlets: {0}", meshletsName);
+					}
+				}
+			}
+
 		}
 		else
 		{
@@ -654,6 +1382,62 @@ namespace Unvoxeller
 		return results;
 	}
 
+	void VoxellerInit()
+	{
+		VoxellerApp::init();
+	}
+
+	ExportResults Unvoxeller::ExportVoxToModel(const ExportOptions& eOptions, const ConvertOptions& cOptions)
+	{
+		if(eOptions.InputPath.empty())
+		{
+			LOG_ERROR("Path is empty");
+
+			return { ConvertMSG::ERROR_EMPTY_PATH };
+		}
+
+		MeshedModels meshedModels{};
+		std::shared_ptr<vox_file> voxData = ReadVoxFile(eOptions.InputPath, cOptions, meshedModels);
+		const auto scenes = Run(voxData.get(), cOptions, &meshedModels, nullptr, eOptions.StreamTextures);
+
+		std::unordered_set<const TextureData*> savedTextures{};
+		return ExportScenes(scenes, eOptions, cOptions, savedTextures);
+	}
+
+	ExportResults Unvoxeller::ExportVoxBatchToModels(const std::vector<std::string>& inVoxPaths, const ExportOptions& eOptions, const ConvertOptions& cOptions)
+	{
+		std::vector<std::shared_ptr<vox_file>> voxFiles{};
+		std::vector<std::shared_ptr<TextureData>> batchTextures{};
+		const auto filesScenes = RunBatch(inVoxPaths, cOptions, voxFiles, eOptions.StreamTextures, &batchTextures);
+
+		// The shared pages are saved first, named after the output, LOD pages are saved with the file they belong to
+		std::unordered_set<const TextureData*> savedTextures{};
+		for (size_t i = 0; i < batchTextures.size(); ++i)
+		{
+			SaveTexture(*batchTextures[i], eOptions.OutputName + (batchTextures.size() > 1 ? "_" + std::to_string(i) : ""), eOptions);
+			savedTextures.insert(batchTextures[i].get());
+		}
+
+		ExportResults results{};
+		results.Msg = filesScenes.empty() ? ConvertMSG::FAILED : ConvertMSG::SUCESS;
+
+		for (size_t f = 0; f < filesScenes.size(); ++f)
+		{
+			// Model files are named after their vox file
+			ExportOptions fileOptions = eOptions;
+			fileOptions.InputPath = inVoxPaths[f];
+			fileOptions.OutputName = std::filesystem::path(inVoxPaths[f]).stem().string();
+
+			if (ExportScenes(filesScenes[f], fileOptions, cOptions, savedTextures).Msg != ConvertMSG::SUCESS)
+			{
+				LOG_ERROR("Can't export: {0}", inVoxPaths[f]);
+				results.Msg = ConvertMSG::FAILED;
+			}
+		}
+
+		return results;
+	}
+
 	ExportResults Unvoxeller::ExportScene(const ExportOptions& eOptions, const ConvertOptions& cOptions, const std::weak_ptr<UnvoxScene> scene)
 	{
 		ExportResults results{};
@@ -677,8 +1461,9 @@ namespace Unvoxeller
 
 	ConvertResult Unvoxeller::VoxToMem(const std::string& inVoxPath, const ConvertOptions& options)
 	{
-		std::shared_ptr<vox_file> voxData = VoxParser::read_vox_file(inVoxPath.c_str());
-		const auto scenes = Run(voxData.get(), options);
+		MeshedModels meshedModels{};
+		std::shared_ptr<vox_file> voxData = ReadVoxFile(inVoxPath, options, meshedModels);
+		const auto scenes = Run(voxData.get(), options, &meshedModels);
 		ConvertResult result{};
 		result.Scenes = scenes;
 		result.Msg = ConvertMSG::SUCESS;
@@ -686,6 +1471,21 @@ namespace Unvoxeller
 		return result;
 	}
 
+	std::vector<ConvertResult> Unvoxeller::VoxBatchToMem(const std::vector<std::string>& inVoxPaths, const ConvertOptions& options)
+	{
+		std::vector<ConvertResult> results{};
+		std::vector<std::shared_ptr<vox_file>> voxFiles{};
+		for (auto& scenes : RunBatch(inVoxPaths, options, voxFiles))
+		{
+			ConvertResult result{};
+			result.Msg = scenes.empty() ? ConvertMSG::FAILED : ConvertMSG::SUCESS;
+			result.Scenes = std::move(scenes);
+			results.push_back(result);
+		}
+
+		return results;
+	}
+
 	ConvertResult Unvoxeller::VoxToMem(const char* buffer, int size, const ConvertOptions& options)
 	{
 		LOG_ERROR("Not implemented");
@@ -0,0 +1,139 @@
+#include <Unvoxeller/VertexQuantizer.h>
+#include <Unvoxeller/Log/Log.h>
+#include <glm/common.hpp>
+#include <glm/ext/vector_int3_sized.hpp>
+#include <glm/ext/vector_uint3_sized.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace Unvoxeller
+{
+	static constexpr f32 SNORM8_MAX = 127.0f;
+	static constexpr f32 UNORM16_MAX = 65535.0f;
+
+	static bool IsWhole(f32 value)
+	{
+		return std::floor(value) == value;
+	}
+
+	bool VertexQuantizer::Quantize(UnvoxMesh& mesh)
+	{
+		const size_t count = mesh.Vertices.size();
+
+		if (count == 0 || mesh.Normals.size() != count || (!mesh.UVs.empty() && mesh.UVs.size() != count))
+		{
+			return false;
+		}
+
+		glm::vec3 minPos(F32_MAX_VAL);
+		glm::vec3 maxPos(F32_MIN_VAL);
+		glm::bvec3 wholeUnits(true);
+
+		for (const auto& p : mesh.Vertices)
+		{
+			for (s32 a = 0; a < 3; ++a)
+			{
+				if (!IsWhole(p[a] * 2.0f))
+				{
+					return false;
+				}
+
+				wholeUnits[a] = wholeUnits[a] && IsWhole(p[a]);
+			}
+
+			minPos = glm::min(minPos, p);
+			maxPos = glm::max(maxPos, p);
+		}
+
+		// Half unit steps only on the axes that need them
+		glm::vec3 scale{};
+		f32 maxSteps = 0.0f;
+		for (s32 a = 0; a < 3; ++a)
+		{
+			scale[a] = wholeUnits[a] ? 1.0f : 0.5f;
+			maxSteps = std::max(maxSteps, (maxPos[a] - minPos[a]) / scale[a]);
+		}
+
+		if (maxSteps > f32(std::numeric_limits<u16>::max()))
+		{
+			LOG_WARN("Mesh '{0}' spans {1} steps, too big for 16 bit positions, vertices won't be quantized", mesh.Name, maxSteps);
+			return false;
+		}
+
+		auto& q = mesh.Quantized;
+		q = {};
+		q.PositionScale = scale;
+		q.PositionOffset = minPos;
+
+		if (maxSteps <= f32(std::numeric_limits<u8>::max()))
+		{
+			q.Positions8.resize(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const glm::vec3 steps = (mesh.Vertices[i] - minPos) / scale;
+				q.Positions8[i] = glm::u8vec4(glm::u8vec3(steps), 0);
+			}
+		}
+		else
+		{
+			q.Positions16.resize(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const glm::vec3 steps = (mesh.Vertices[i] - minPos) / scale;
+				q.Positions16[i] = glm::u16vec4(glm::u16vec3(steps), 0);
+			}
+		}
+
+		q.Normals.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const glm::vec3 n = glm::round(glm::clamp(mesh.Normals[i], -1.0f, 1.0f) * SNORM8_MAX);
+			q.Normals[i] = glm::i8vec4(glm::i8vec3(n), 0);
+		}
+
+		q.UVs.resize(mesh.UVs.size());
+		for (size_t i = 0; i < mesh.UVs.size(); ++i)
+		{
+			q.UVs[i] = glm::u16vec2(glm::round(glm::clamp(mesh.UVs[i], 0.0f, 1.0f) * UNORM16_MAX));
+		}
+
+		// Release the float arrays, not just clear them
+		std::vector<glm::vec3>().swap(mesh.Vertices);
+		std::vector<glm::vec3>().swap(mesh.Normals);
+		std::vector<glm::vec2>().swap(mesh.UVs);
+
+		return true;
+	}
+
+	void VertexQuantizer::Dequantize(UnvoxMesh& mesh)
+	{
+		auto& q = mesh.Quantized;
+		const size_t count = q.GetVertexCount();
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		mesh.Vertices.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const glm::vec3 steps = q.Positions8.empty() ? glm::vec3(glm::u16vec3(q.Positions16[i])) : glm::vec3(glm::u8vec3(q.Positions8[i]));
+			mesh.Vertices[i] = steps * q.PositionScale + q.PositionOffset;
+		}
+
+		mesh.Normals.resize(q.Normals.size());
+		for (size_t i = 0; i < q.Normals.size(); ++i)
+		{
+			mesh.Normals[i] = glm::vec3(glm::i8vec3(q.Normals[i])) / SNORM8_MAX;
+		}
+
+		mesh.UVs.resize(q.UVs.size());
+		for (size_t i = 0; i < q.UVs.size(); ++i)
+		{
+			mesh.UVs[i] = glm::vec2(q.UVs[i]) / UNORM16_MAX;
+		}
+
+		q = {};
+	}
+}
@@ -13,13 +13,10 @@
 
 namespace Unvoxeller
 {
-    int VoxParser::modelIndex = 0;
-
     vox_header VoxParser::read_vox_metadata(const char* path)
     {
         std::ifstream voxFile(path, std::ios::binary);
         vox_header header{};
-        modelIndex = 0;
         if (voxFile.is_open())
         {
             char magic[4];
@@ -43,6 +40,12 @@ namespace Unvoxeller
     }
 
     std::shared_ptr<vox_file> VoxParser::read_vox_file(const char* path)
+    {
+        return read_vox_file(path, nullptr);
+    }
+
+    // The read state lives in this call, so several files can be read at once from different threads.
+    std::shared_ptr<vox_file> VoxParser::read_vox_file(const char* path, const model_read_callback& onModelRead)
     {
         std::ifstream voxFile(path, std::ios::binary);
         if (!voxFile.is_open())
@@ -102,7 +105,6 @@ namespace Unvoxeller
         voxFile.read(reinterpret_cast<char*>(&mainChildrenBytes), 4);
 
         // Loop through all chunks inside MAIN
-        modelIndex = 0;
         while (true) {
             char chunkId[4];
             if (!voxFile.read(chunkId, 4)) {
@@ -121,7 +123,7 @@ namespace Unvoxeller
                 parse_SIZE(vox, voxFile, chunkContentBytes, chunkChildrenBytes);
             }
             else if (chunkStr == "XYZI") {
-                parse_XYZI(vox, voxFile, chunkContentBytes, chunkChildrenBytes);
+                parse_XYZI(vox, voxFile, chunkContentBytes, chunkChildrenBytes, onModelRead);
             }
             else if (chunkStr == "RGBA") {
                 sawRGBA = true;
@@ -239,14 +241,15 @@ namespace Unvoxeller
     }
 
     void VoxParser::parse_XYZI(std::shared_ptr<vox_file> vox, std::ifstream& voxFile,
-        uint32_t /*contentBytes*/, uint32_t childrenBytes)
+        uint32_t /*contentBytes*/, uint32_t childrenBytes, const model_read_callback& onModelRead)
     {
         uint32_t numVoxels = 0;
         voxFile.read(reinterpret_cast<char*>(&numVoxels), 4);
         vox_model model;
         model.voxels.resize(numVoxels);
 
-        const vox_size& size = vox->sizes[modelIndex++];
+        const s32 modelIndex = static_cast<s32>(vox->voxModels.size());
+        const vox_size& size = vox->sizes[modelIndex];
         int sx = size.x, sy = size.y, sz = size.z;
         model.voxel_3dGrid = new int** [sz];
         for (int z = 0; z < sz; ++z) {
@@ -286,6 +289,11 @@ namespace Unvoxeller
 
         vox->voxModels.push_back(std::move(model));
 
+        if (onModelRead)
+        {
+            onModelRead(modelIndex, vox->voxModels.back(), size);
+        }
+
         if (childrenBytes > 0) {
             voxFile.seekg(childrenBytes, std::ios::cur);
         }
@@ -0,0 +1,144 @@
+#include <Unvoxeller/VoxelDownsampler.h>
+#include <Unvoxeller/ParallelFor.h>
+#include <algorithm>
+
+namespace Unvoxeller
+{
+	static s32 GetDownsampledSize(s32 size)
+	{
+		return std::max((size + 1) / 2, 1);
+	}
+
+	// Downsamples 'source' into 'model', 'cells' gets its grid.
+	static void DownsampleModel(const vox_model& source, const vox_size& size, f32 fill, vox_model& model, const vox_size& mipSize,
+								std::vector<s32>& cells, std::vector<s32**>& slices, std::vector<s32*>& rows)
+	{
+		cells.assign(size_t(mipSize.x) * mipSize.y * mipSize.z, -1);
+		slices.resize(mipSize.z);
+		rows.resize(size_t(mipSize.y) * mipSize.z);
+
+		for (s32 z = 0; z < mipSize.z; ++z)
+		{
+			slices[z] = &rows[size_t(z) * mipSize.y];
+			for (s32 y = 0; y < mipSize.y; ++y)
+			{
+				rows[size_t(z) * mipSize.y + y] = &cells[(size_t(z) * mipSize.y + y) * mipSize.x];
+			}
+		}
+
+		model.voxel_3dGrid = slices.data();
+
+		for (s32 z = 0; z < mipSize.z; ++z)
+		{
+			for (s32 y = 0; y < mipSize.y; ++y)
+			{
+				for (s32 x = 0; x < mipSize.x; ++x)
+				{
+					// Colors of the filled cells of the block, blocks on odd edges have less cells
+					u8 colors[8]{};
+					s32 filled = 0, blockCells = 0;
+
+					for (s32 bz = z * 2; bz < std::min(z * 2 + 2, size.z); ++bz)
+					{
+						for (s32 by = y * 2; by < std::min(y * 2 + 2, size.y); ++by)
+						{
+							for (s32 bx = x * 2; bx < std::min(x * 2 + 2, size.x); ++bx)
+							{
+								const s32 cell = source.voxel_3dGrid[bz][by][bx];
+								if (cell >= 0)
+								{
+									colors[filled++] = source.voxels[cell].colorIndex;
+								}
+
+								++blockCells;
+							}
+						}
+					}
+
+					if (filled == 0 || f32(filled) < fill * f32(blockCells))
+					{
+						continue;
+					}
+
+					// Most common color, ties go to the first one found
+					u8 color = colors[0];
+					s32 colorCount = 0;
+					for (s32 i = 0; i < filled; ++i)
+					{
+						const s32 count = s32(std::count(colors, colors + filled, colors[i]));
+						if (count > colorCount)
+						{
+							color = colors[i];
+							colorCount = count;
+						}
+					}
+
+					rows[size_t(z) * mipSize.y + y][x] = s32(model.voxels.size());
+					model.voxels.push_back({ u8(x), u8(y), u8(z), color });
+
+					bbox& box = model.boundingBox;
+					box.minX = std::min(box.minX, f32(x));
+					box.minY = std::min(box.minY, f32(y));
+					box.minZ = std::min(box.minZ, f32(z));
+					box.maxX = std::max(box.maxX, f32(x + 1));
+					box.maxY = std::max(box.maxY, f32(y + 1));
+					box.maxZ = std::max(box.maxZ, f32(z + 1));
+				}
+			}
+		}
+	}
+
+	std::shared_ptr<VoxelMip> VoxelDownsampler::Downsample(const vox_file& source, f32 fill)
+	{
+		auto mip = std::make_shared<VoxelMip>();
+		mip->Data = std::make_shared<vox_file>();
+
+		vox_file& data = *mip->Data;
+		data.header = source.header;
+		data.palette = source.palette;
+		data.transforms = source.transforms;
+		data.groups = source.groups;
+		data.shapes = source.shapes;
+		data.materials = source.materials;
+		data.layers = source.layers;
+		data.isValid = source.isValid;
+		data.voxelScale = source.voxelScale * 2;
+		data.sourceSizes = source.sourceSizes.empty() ? source.sizes : source.sourceSizes;
+
+		const size_t modelCount = source.voxModels.size();
+		data.sizes.resize(modelCount);
+		data.voxModels.resize(modelCount);
+		mip->Cells.resize(modelCount);
+		mip->Slices.resize(modelCount);
+		mip->Rows.resize(modelCount);
+
+		ParallelFor(modelCount, 1, [&](size_t i)
+		{
+			const vox_size& size = source.sizes[i];
+			data.sizes[i] = { GetDownsampledSize(size.x), GetDownsampledSize(size.y), GetDownsampledSize(size.z) };
+
+			DownsampleModel(source.voxModels[i], size, std::clamp(fill, 0.0f, 1.0f), data.voxModels[i], data.sizes[i], mip->Cells[i], mip->Slices[i], mip->Rows[i]);
+
+			// Thin models would vanish, they keep every block with a voxel instead
+			if (data.voxModels[i].voxels.empty() && !source.voxModels[i].voxels.empty())
+			{
+				data.voxModels[i] = {};
+				DownsampleModel(source.voxModels[i], size, 0.0f, data.voxModels[i], data.sizes[i], mip->Cells[i], mip->Slices[i], mip->Rows[i]);
+			}
+		});
+
+		return mip;
+	}
+
+	std::vector<std::shared_ptr<VoxelMip>> VoxelDownsampler::BuildPyramid(const vox_file& source, s32 levels, f32 fill)
+	{
+		std::vector<std::shared_ptr<VoxelMip>> mips{};
+
+		for (s32 level = 0; level < levels; ++level)
+		{
+			mips.push_back(Downsample(level == 0 ? source : *mips.back()->Data, fill));
+		}
+
+		return mips;
+	}
+}
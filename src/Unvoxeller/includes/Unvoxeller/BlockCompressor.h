@@ -0,0 +1,22 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/Data/TextureFormat.h>
+#include <vector>
+
+namespace Unvoxeller
+{
+	// CPU encoders for GPU block compressed formats, images are split in 4x4 tiles that are compressed on worker threads.
+	struct BlockCompressor
+	{
+		// 16 RGBA8 texels (row major) to an 8 bytes BC1 block, alpha is ignored.
+		static void EncodeBC1Block(const u8* texels, u8* block);
+
+		// 16 RGBA8 texels (row major) to a 16 bytes BC7 block (mode 6).
+		static void EncodeBC7Block(const u8* texels, u8* block);
+
+		static size_t GetBlockBytes(TextureFormat format);
+
+		// Compress a whole RGBA8 image in 'format' (BC1 or BC7), partial blocks at the right/bottom edges repeat the last column/row.
+		static std::vector<u8> Compress(const u8* rgba, s32 width, s32 height, TextureFormat format);
+	};
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace Unvoxeller 
+{
+    enum class AtlasPackerType
+    {
+        // Rows of rectangles, simple and fast, wastes the space above short rectangles of a row.
+        Shelf,
+        // Bottom-left skyline, fills the gaps left by short rectangles. Tighter atlases.
+        Skyline,
+    };
+}
@@ -4,6 +4,8 @@
 #include <Unvoxeller/Types.h>
 #include <Unvoxeller/Data/TextureType.h>
 #include <Unvoxeller/Data/MeshType.h>
+#include <Unvoxeller/Data/AtlasPackerType.h>
+#include <Unvoxeller/Data/LodType.h>
 #include <vector>
 
 namespace Unvoxeller 
@@ -26,6 +28,24 @@ namespace Unvoxeller
 		// Make Textures to always be power of two
 		bool TexturesPOT = false;
 
+		// Texture layout when using 'TextureType::Palette'.
+		PaletteTextureConfig Palette{};
+
+		// How faces are placed in the atlas.
+		AtlasPackerType Packer = AtlasPackerType::Skyline;
+
+		// Surround every atlas face with a 1 texel border copied from its edges, so bilinear filtering doesn't bleed neighbor faces.
+		// Without borders faces are packed edge to edge and uvs are inset 1/64 texel, use it with nearest filtering (smaller atlases).
+		bool AtlasBorders = true;
+
+		// Mip levels to generate for atlases (0 = none), faces get padded to cells aligned to 2^AtlasMips texels so downsampling never mixes them.
+		// Every level doubles the alignment, so 2-3 is usually enough. Mips are written in .ktx2 textures, and kept in 'TextureData::Mips'.
+		s32 AtlasMips = 0;
+
+		// Max width/height of an atlas, faces that don't fit will spill into more atlas pages (textures),
+		// meshes will be split per page. Ex: set 2048 for engines that can't go higher.
+		s32 MaxAtlasSize = 4096;
+
 		// Should every mesh have a separated texture?
 		bool SeparateTexturesPerMesh = false;
 
@@ -33,6 +53,10 @@ namespace Unvoxeller
 		// NOTE: Baking with this uv mapping, could produce issues since uv islands are "merged" by color.
 		bool ReuseColors = false;
 
+		// With 'ExportFramesSeparatelly', every frame scene uses one atlas with the faces of all the frames, instead of one atlas per frame.
+		// Models shown in several frames are packed once and identical faces of different models share texels. Overrides 'SeparateTexturesPerMesh'.
+		bool SharedFramesAtlas = false;
+
 		bool ReuseTextures = false;
 		// If true:
 		// -When exporting separated textures per mesh, materials will reuse the textures files (Ex: two materials could point to the same texture)
@@ -82,6 +106,33 @@ namespace Unvoxeller
 
 		MeshType MeshType = MeshType::Greedy;
 
+		// Store the palette color of every face in its vertices (RGBA) instead of texturing, no textures will be generated.
+		// Faces will be meshed by color (see MeshType::Palette).
+		bool VertexColors = false;
+
+		// With 'VertexColors', also store the raw palette index (1–255) of every vertex, exported as the uv channel after the regular uvs (u = index).
+		bool VertexPaletteIndices = false;
+
+		// Store vertices in 'UnvoxMesh::Quantized' instead of the float arrays: 8/16 bit positions on the mesh grid, snorm8 normals and unorm16 uvs.
+		// Meshes that can't be quantized exactly keep their floats, exporters without quantized attributes get dequantized vertices.
+		bool QuantizeVertices = false;
+
+		// Meshes get 16 bit indices ('UnvoxMesh::Indices16'), meshes with more than 65535 vertices are split in spatially coherent parts
+		// that share their material/texture.
+		bool Use16BitIndices = false;
+
+		// Reorder every mesh for the GPU (meshoptimizer): triangles for the post transform vertex cache and overdraw, vertices for fetch locality.
+		// Only the order changes, ACMR/ATVR before and after are logged per scene.
+		bool OptimizeForGPU = false;
+
+		// Split every mesh in meshlets with bounding spheres and normal cones for cluster culling ('UnvoxMesh::Meshlets'),
+		// exports write them next to every model file as '.meshlets' (see 'MeshletWriter').
+		bool BuildMeshlets = false;
+
+		// Meshlet limits, up to 256 vertices and 512 triangles (rounded down to a multiple of 4). 64/124 suits most mesh shading hardware.
+		u32 MeshletMaxVertices = 64;
+		u32 MeshletMaxTriangles = 124;
+
 		VisibleSides Sides;
 	};
 
@@ -99,14 +150,30 @@ namespace Unvoxeller
 		// Export meshes in different files.
 		bool ExportMeshesSeparatelly = false; // Move this to export options
 
+		// Start meshing every model on a worker thread as soon as it is read, instead of waiting for the whole file.
+		// Useful for big multi-model files stored in slow drives/network mounts, file I/O and meshing will overlap.
+		bool PipelinedParsing = false;
+
 		MeshingOptions Meshing{};
 
 		// Texturing options
 		TexturingOptions Texturing{};
 
 		// To create n lods set factors (0.0 - 1.0), 1.0 = no change, Factor[0] = LOD1, Factor[1] = LOD2
+		// Every non zero factor makes a simplified copy of all the meshes keeping that share of their triangles ('UnvoxScene::Lods'),
+		// exported under '_LOD1', '_LOD2'... nodes next to the '_LOD0' one with the full meshes.
 		std::vector<f32> Lods = { 0,0,0,0,0,0,0,0,0,0 };
 
+		// With 'LodType::Downsample' the factors only turn the levels on, LOD n has the models downsampled 2^n times.
+		LodType LodMode = LodType::Simplify;
+
+		// LOD meshes stop simplifying before their error goes over this (relative to the mesh size, 0.05 = 5%), even if they keep more triangles.
+		f32 LodMaxError = 0.05f;
+
+		// Downsampled LODs: share of the voxels of a block (0 - 1) that have to be filled for its LOD voxel to be kept, which gets their most common color.
+		// 0.25 keeps lines one voxel thick, higher values drop thin details, 0 keeps every block with a voxel but grows the models.
+		f32 LodVoxelFill = 0.25f;
+
 		// Scale, Ex, if 1.0, every single voxel will take up 1 unit.
 		glm::vec3 Scale = { 1.0f, 1.0f, 1.0f };
 		
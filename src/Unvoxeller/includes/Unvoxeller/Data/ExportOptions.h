@@ -1,6 +1,7 @@
 #pragma once
 #include <Unvoxeller/api.h>
 #include <Unvoxeller/Types.h>
+#include <Unvoxeller/Data/TextureFormat.h>
 #include <string>
 
 namespace Unvoxeller
@@ -20,5 +21,18 @@ namespace Unvoxeller
 		std::string OutputDir;
 		std::string OutputName;
 		ModelFormat OutputFormat = ModelFormat::FBX;
+
+		// Texture files format, 'PGN', or 'BC1'/'BC7' to ship GPU ready .ktx2 files. Other formats are written as png.
+		TextureFormat TexturesFormat = TextureFormat::PGN;
+
+		// Write the whole mip chain in .ktx2 textures.
+		bool TextureMips = true;
+
+		// Png textures compression, 0 = stored (fastest, biggest files, good for iteration builds), 1 = fast, 9 = smallest.
+		s32 PngCompressionLevel = 6;
+
+		// Atlas pages aren't kept in memory, they are drawn a band of rows at a time while the png is written (a page at a time for .ktx2 files).
+		// Ignored with 'TexturingOptions::AtlasMips', mips are made from whole pages.
+		bool StreamTextures = false;
 	};
 }
\ No newline at end of file
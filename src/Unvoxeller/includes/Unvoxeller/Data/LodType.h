@@ -0,0 +1,13 @@
+#pragma once
+
+namespace Unvoxeller 
+{
+    // How 'ConvertOptions::Lods' are made.
+    enum class LodType
+    {
+        // Simplified copies of the meshes triangles, smooth but they lose the blocky look (and barely change textured meshes).
+        Simplify,
+        // The models are downsampled 2x per LOD level (LOD1 = 2x, LOD2 = 4x...) and meshed and textured again, they stay blocky.
+        Downsample,
+    };
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <Unvoxeller/api.h>
+#include <Unvoxeller/Types.h>
+
+namespace Unvoxeller
+{
+	// Post transform vertex cache efficiency, simulated with a FIFO cache of 16 vertices.
+	struct UNVOXELLER_API MeshCacheStats
+	{
+		// Average cache miss ratio: transformed vertices per triangle, 0.5 at best and 3 without any reuse.
+		f32 ACMR = 0.0f;
+
+		// Average transformed vertex ratio: transformed vertices per vertex, 1 at best.
+		f32 ATVR = 0.0f;
+	};
+}
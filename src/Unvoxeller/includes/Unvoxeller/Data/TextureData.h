@@ -4,6 +4,7 @@
 #include <Unvoxeller/Types.h>
 #include "TextureFormat.h"
 #include <string>
+#include <functional>
 
 namespace Unvoxeller 
 {
@@ -14,5 +15,11 @@ namespace Unvoxeller
         TextureFormat Format;
         f32 Width;
         f32 Height;
+
+        // Mip levels after 'Buffer' (level 1 onward), every one half the size of the previous one, see 'TexturingOptions::AtlasMips'.
+        std::vector<std::vector<unsigned char>> Mips;
+
+        // Set instead of 'Buffer' when atlas pages are streamed (see 'ExportOptions::StreamTextures'), draws 'rowCount' RGBA rows from 'firstRow' in 'rgba'.
+        std::function<void(s32 firstRow, s32 rowCount, u8* rgba)> DrawRows;
     };
 }
\ No newline at end of file
@@ -12,5 +12,20 @@ namespace Unvoxeller
         JPG,
         // Encode as .tga
         TGA,
+        // GPU block compressed .ktx2, opaque RGB at 4 bits per pixel.
+        BC1,
+        // GPU block compressed .ktx2, RGBA at 8 bits per pixel.
+        BC7,
     };
-}
\ No newline at end of file
+
+    inline bool IsBlockCompressed(TextureFormat format)
+    {
+        return format == TextureFormat::BC1 || format == TextureFormat::BC7;
+    }
+
+    // Extension of the texture files written for 'format', formats without a writer fall back to png.
+    inline const char* GetTextureFileExtension(TextureFormat format)
+    {
+        return IsBlockCompressed(format) ? ".ktx2" : ".png";
+    }
+}
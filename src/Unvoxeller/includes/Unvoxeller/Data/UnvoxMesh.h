@@ -5,12 +5,31 @@
 #include <Unvoxeller/Types.h>
 #include <Unvoxeller/VoxelTypes.h>
 #include <Unvoxeller/api.h>
+#include <Unvoxeller/Data/UnvoxMeshlet.h>
+#include <glm/ext/vector_int4_sized.hpp>
+#include <glm/ext/vector_uint2_sized.hpp>
+#include <glm/ext/vector_uint4_sized.hpp>
 
 namespace Unvoxeller
 {
-    struct UNVOXELLER_API UnvoxFace
+    // Compact vertex layout (see 'MeshingOptions::QuantizeVertices'), attributes are laid out as glTF 'KHR_mesh_quantization' expects them:
+    // integer positions, normalized normals/uvs, and 4 byte aligned elements.
+    struct UNVOXELLER_API UnvoxQuantizedVertices
     {
-        std::vector<u32> Indices;
+        // Vertex i is at 'xyz * PositionScale + PositionOffset', w is padding.
+        // Only one of them is used: 8 bits per axis when the mesh spans up to 255 steps, 16 otherwise.
+        std::vector<glm::u8vec4> Positions8;
+        std::vector<glm::u16vec4> Positions16;
+        glm::vec3 PositionScale = { 1.0f, 1.0f, 1.0f };
+        glm::vec3 PositionOffset = { 0.0f, 0.0f, 0.0f };
+
+        // snorm8 (n * 127), w is padding.
+        std::vector<glm::i8vec4> Normals;
+
+        // unorm16 (uv * 65535), empty with vertex colors.
+        std::vector<glm::u16vec2> UVs;
+
+        size_t GetVertexCount() const { return Positions8.size() + Positions16.size(); }
     };
 
     struct UNVOXELLER_API UnvoxMesh 
@@ -23,6 +42,33 @@ namespace Unvoxeller
         std::vector<glm::vec3> Normals;
         std::vector<glm::vec2> UVs;
 
-        std::vector<UnvoxFace> Faces;
+        // Replaces 'Vertices', 'Normals' and 'UVs' (left empty) when the mesh is quantized.
+        UnvoxQuantizedVertices Quantized;
+
+        // Only when using vertex colors, empty otherwise.
+        std::vector<color> Colors;
+        std::vector<u8> ColorIndices;
+
+        // Faces as one index buffer, every face takes 'IndicesPerFace' consecutive indices (3, triangles, for every mesh built here).
+        std::vector<u32> Indices;
+        u32 IndicesPerFace = 3;
+
+        // Replaces 'Indices' (left empty) with 'MeshingOptions::Use16BitIndices', meshes are split so they never need more.
+        std::vector<u16> Indices16;
+
+        // Only with 'MeshingOptions::BuildMeshlets': clusters of the mesh triangles, they point to mesh vertices through 'MeshletVertices'
+        // and keep their triangles as 8 bit local indices in 'MeshletTriangles'. Triangles are also in the index buffer.
+        std::vector<UnvoxMeshlet> Meshlets;
+        std::vector<u32> MeshletVertices;
+        std::vector<u8> MeshletTriangles;
+
+        bool IsQuantized() const { return Quantized.GetVertexCount() > 0; }
+
+        size_t GetIndexCount() const { return Indices.size() + Indices16.size(); }
+
+        // Index 'i' of whichever index buffer the mesh uses.
+        u32 GetIndex(size_t i) const { return Indices16.empty() ? Indices[i] : Indices16[i]; }
+
+        size_t GetFaceCount() const { return IndicesPerFace > 0 ? GetIndexCount() / IndicesPerFace : 0; }
     };
 }
\ No newline at end of file
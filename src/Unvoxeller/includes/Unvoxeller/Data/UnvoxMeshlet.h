@@ -0,0 +1,28 @@
+#pragma once
+#include <Unvoxeller/api.h>
+#include <Unvoxeller/Types.h>
+#include <glm/vec3.hpp>
+
+namespace Unvoxeller
+{
+	// A small cluster of mesh triangles with its culling bounds (see 'MeshingOptions::BuildMeshlets').
+	struct UNVOXELLER_API UnvoxMeshlet
+	{
+		// Vertex i of the meshlet is mesh vertex 'UnvoxMesh::MeshletVertices[VertexOffset + i]'.
+		u32 VertexOffset = 0;
+		u32 VertexCount = 0;
+
+		// Triangles are 3 meshlet vertex indices each, starting at byte 'TriangleOffset' of 'UnvoxMesh::MeshletTriangles'.
+		u32 TriangleOffset = 0;
+		u32 TriangleCount = 0;
+
+		// Bounding sphere, for frustum and occlusion culling.
+		glm::vec3 Center = { 0.0f, 0.0f, 0.0f };
+		f32 Radius = 0.0f;
+
+		// Normal cone, the whole meshlet faces away from a camera at 'eye' when: dot(normalize(ConeApex - eye), ConeAxis) >= ConeCutoff.
+		glm::vec3 ConeApex = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 ConeAxis = { 0.0f, 0.0f, 0.0f };
+		f32 ConeCutoff = 1.0f;
+	};
+}
@@ -2,6 +2,7 @@
 #include <Unvoxeller/Data/UnvoxMesh.h>
 #include <Unvoxeller/api.h>
 #include <Unvoxeller/Data/TextureData.h>
+#include <Unvoxeller/Data/MeshCacheStats.h>
 
 namespace Unvoxeller
 {
@@ -20,6 +21,20 @@ namespace Unvoxeller
         s32 TextureIndex = 0;
     };
 
+    // Lower detail meshes of the scene (see 'ConvertOptions::Lods'). Simplified LODs have a copy of every scene mesh, 'Meshes[i]' is the LOD of
+    // the scene mesh i. Downsampled ones are meshed again, so they have their own meshes and materials.
+    struct UNVOXELLER_API UnvoxLod
+    {
+        // 'ConvertOptions::Lods[Level - 1]' made it
+        s32 Level = 0;
+        f32 Factor = 1.0f;
+
+        // Largest simplification error of the meshes, relative to their size. Downsampled LODs get their voxel size relative to the largest model.
+        f32 Error = 0.0f;
+
+        std::vector<std::shared_ptr<UnvoxMesh>> Meshes;
+    };
+
     struct UNVOXELLER_API UnvoxScene
     {
         std::string Name = "";
@@ -27,5 +42,24 @@ namespace Unvoxeller
         std::shared_ptr<UnvoxNode> RootNode = nullptr;
         std::vector<std::shared_ptr<UnvoxMaterial>> Materials;
         std::vector<std::shared_ptr<TextureData>> Textures;
+
+        // Ordered by level, their materials and textures are in the scene ones.
+        std::vector<UnvoxLod> Lods;
+
+        // 'Meshes' followed by the meshes of every LOD, the order model files get them in.
+        std::vector<std::shared_ptr<UnvoxMesh>> GetAllMeshes() const
+        {
+            std::vector<std::shared_ptr<UnvoxMesh>> meshes = Meshes;
+            for (const auto& lod : Lods)
+            {
+                meshes.insert(meshes.end(), lod.Meshes.begin(), lod.Meshes.end());
+            }
+
+            return meshes;
+        }
+
+        // Vertex cache stats of all the meshes before and after 'MeshingOptions::OptimizeForGPU', zero without it.
+        MeshCacheStats CacheStatsBefore{};
+        MeshCacheStats CacheStatsAfter{};
     };
 }
\ No newline at end of file
@@ -14,8 +14,10 @@ struct FaceRect
 {
 	Orientation orientation;
 	s32 w, h;        // dimensions (including border will be added around)
-	s32 atlasX, atlasY; // top-left position in atlas (including border) after packing
+	s32 atlasX = 0, atlasY = 0; // position in the atlas of the first texel of the face after packing (borders, if any, are around it)
+	s32 atlasPage = 0; // atlas texture this face was packed in, when faces don't fit in a single one
 	u8 colorIndex; // palette index (for color)
+	bool uniformColor = false; // the whole face is a single color drawn by one atlas texel, uvs go to its center
 	// face orientation and extents for UV mapping
 	// Face extents in voxel coordinates (the *inclusive* start and end boundaries of the face in world coordinates)
 	s32 uMin, uMax;  // min and max along face's U-axis (in world coords, face boundary)
@@ -0,0 +1,18 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/Data/TextureFormat.h>
+#include <string>
+#include <vector>
+
+namespace Unvoxeller
+{
+	// KTX2 writer for GPU block compressed textures, rows keep the png order (KTXorientation "rd", first row is the top).
+	struct KtxWriter
+	{
+		// 'format' must be block compressed (see 'IsBlockCompressed'), 'mips' adds the whole mip chain down to 1x1.
+		// 'mipLevels' are levels already generated (ex: 'TextureData::Mips'), they are used first and the rest is downsampled from the last one.
+		static bool Encode(const u8* rgba, s32 width, s32 height, const std::vector<std::vector<u8>>& mipLevels, TextureFormat format, bool mips, std::vector<u8>& ktx);
+
+		static bool Write(const std::string& path, const u8* rgba, s32 width, s32 height, const std::vector<std::vector<u8>>& mipLevels, TextureFormat format, bool mips);
+	};
+}
@@ -11,16 +11,26 @@ namespace Unvoxeller
     class MeshBuilder
     {
     public:
+    // Most vertices a mesh with 16 bit indices can have, 0xFFFF is left free for primitive restart.
+    static constexpr size_t MAX_16BIT_VERTICES = 65535;
+
     // Build the actual geometry (vertices and indices) for a mesh from the FaceRect list and a given texture atlas configuration.
+    // 'texWidth' and 'texHeight' are the size of the texture the faces were packed in, 0 if there is none (the mesh gets no uvs).
+    // With 'indices16' the mesh gets 'Indices16' if it has up to MAX_16BIT_VERTICES vertices, 'Indices' otherwise.
+    // Downsampled models (see 'vox_file::voxelScale') pass their scale, and their source size as 'size' so they are centered like the source.
     static  std::shared_ptr<UnvoxMesh>  BuildMeshFromFaces(
                 const std::vector<FaceRect>& faces,
                 int texWidth, int texHeight,
-                bool flatShading,
                 const std::vector<color>& palette,
                 const bbox& box,
                 const vox_size& size,
-                const glm::mat3& rotation  = {},
-                const glm::vec3& translation  = {} 
+                const glm::mat3& rotation  = glm::mat3(1.0f),
+                const glm::vec3& translation  = glm::vec3(0.0f),
+                bool vertexColors = false,
+                bool paletteIndices = false,
+                f32 uvInset = 0.0f,
+                bool indices16 = false,
+                s32 voxelScale = 1
             );
     private:
     };
@@ -0,0 +1,20 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/Data/UnvoxMesh.h>
+#include <Unvoxeller/Data/MeshCacheStats.h>
+
+namespace Unvoxeller
+{
+	// GPU friendly ordering of mesh triangles and vertices with meshoptimizer, the geometry itself doesn't change.
+	struct MeshGpuOptimizer
+	{
+		static constexpr u32 CACHE_SIZE = 16;
+
+		// Stats of the mesh as it is ordered now.
+		static MeshCacheStats Analyze(const UnvoxMesh& mesh);
+
+		// Triangles are sorted for the vertex cache then for overdraw, vertices by first use so fetches are sequential.
+		// Works on the float vertices, meshes that aren't triangles or are quantized are left as they are.
+		static void Optimize(UnvoxMesh& mesh);
+	};
+}
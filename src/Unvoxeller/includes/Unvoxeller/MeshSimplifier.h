@@ -0,0 +1,17 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/Data/UnvoxMesh.h>
+#include <memory>
+
+namespace Unvoxeller
+{
+	// Simplified copies of meshes for LODs (meshoptimizer simplifier).
+	struct MeshSimplifier
+	{
+		// Copy of 'mesh' keeping about 'factor' (0 - 1) of its triangles, it can stop short of it so the error stays under 'maxError'
+		// (relative to the mesh size, 0.01 = 1%). Open borders are locked, so split meshes stay closed, and vertices on uv/color
+		// seams only collapse along them (atlas faces have their own uvs, so textured meshes barely change). Normals are rebuilt flat.
+		// 'error' gets the resulting error. Meshes that aren't triangles or are quantized are copied as they are.
+		static std::shared_ptr<UnvoxMesh> Simplify(const UnvoxMesh& mesh, f32 factor, f32 maxError, f32& error);
+	};
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/Data/UnvoxMesh.h>
+
+namespace Unvoxeller
+{
+	// Splits meshes in meshlets (meshoptimizer clusterizer) and computes their culling bounds.
+	struct MeshletBuilder
+	{
+		static constexpr u32 MAX_VERTICES = 256;
+		static constexpr u32 MAX_TRIANGLES = 512;
+
+		// Fills 'mesh.Meshlets', 'mesh.MeshletVertices' and 'mesh.MeshletTriangles', the index buffer is left as it is.
+		// Works on the float vertices, meshes that aren't triangles or are quantized only get their meshlets cleared.
+		static void Build(UnvoxMesh& mesh, u32 maxVertices, u32 maxTriangles);
+	};
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/Data/UnvoxMesh.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Unvoxeller
+{
+	// Sidecar file with the meshlets of every mesh of a model file, the model formats we export can't carry them.
+	// Little endian layout:
+	//  - header: "UVML", u32 version, u32 mesh count
+	//  - per mesh (same order as the meshes in the model file): u32 meshlet count, u32 meshlet vertex count, u32 meshlet triangle count,
+	//    then the meshlets (u32 vertex offset/count, u32 triangle offset/count, f32 center xyz, radius, cone apex xyz, cone axis xyz, cone cutoff),
+	//    the u32 meshlet vertices, and the u8 meshlet triangles (3 per triangle) padded to 4 bytes.
+	struct MeshletWriter
+	{
+		// "UVML" once written little endian.
+		static constexpr u32 MAGIC = 'U' | ('V' << 8) | ('M' << 16) | ('L' << 24);
+		static constexpr u32 VERSION = 1;
+
+		static void Encode(const std::vector<std::shared_ptr<UnvoxMesh>>& meshes, std::vector<u8>& data);
+
+		static bool Write(const std::string& path, const std::vector<std::shared_ptr<UnvoxMesh>>& meshes);
+	};
+}
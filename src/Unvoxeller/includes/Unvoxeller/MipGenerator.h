@@ -0,0 +1,20 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/Data/TextureData.h>
+#include <vector>
+
+namespace Unvoxeller
+{
+	// RGBA8 mip chains, rows are filtered on worker threads and 2x2 blocks with SSE2 when the target has it.
+	struct MipGenerator
+	{
+		// Next mip size of a width or height.
+		static s32 GetMipSize(s32 size) { return size > 1 ? size / 2 : 1; }
+
+		// 2x2 box filter, odd sizes repeat the last row/column.
+		static std::vector<u8> Downsample(const u8* rgba, s32 width, s32 height);
+
+		// Fills 'texture.Mips' with 'levels' mips (level 1 onward), stops earlier if the texture gets to 1x1.
+		static void GenerateMips(TextureData& texture, s32 levels);
+	};
+}
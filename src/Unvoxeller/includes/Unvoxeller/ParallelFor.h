@@ -0,0 +1,38 @@
+#pragma once
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace Unvoxeller
+{
+	// Runs 'fn(i)' for every i in [0, count), items are interleaved across workers since they usually come sorted by size.
+	// A worker is started for every 'minItemsPerWorker' items, up to the hardware threads.
+	template<typename Fn>
+	inline void ParallelFor(size_t count, size_t minItemsPerWorker, const Fn& fn)
+	{
+		const size_t minItems = std::max<size_t>(minItemsPerWorker, 1);
+		const size_t workers = std::clamp<size_t>((count + minItems - 1) / minItems, 1, std::max(1u, std::thread::hardware_concurrency()));
+
+		auto runShare = [&](size_t worker)
+		{
+			for (size_t i = worker; i < count; i += workers)
+			{
+				fn(i);
+			}
+		};
+
+		std::vector<std::future<void>> tasks{};
+		for (size_t worker = 1; worker < workers; ++worker)
+		{
+			tasks.push_back(std::async(std::launch::async, runShare, worker));
+		}
+
+		runShare(0);
+
+		for (auto& task : tasks)
+		{
+			task.get();
+		}
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Unvoxeller
+{
+	// RGBA8 PNG encoder, rows are filtered and deflated in strips on worker threads, so big atlases don't encode on a single core.
+	struct PngWriter
+	{
+		// 'compressionLevel' goes from 0 (stored, fastest) to 9 (smallest), see 'ExportOptions::PngCompressionLevel'.
+		static bool Encode(const u8* rgba, s32 width, s32 height, s32 compressionLevel, std::vector<u8>& png);
+
+		static bool Write(const std::string& path, const u8* rgba, s32 width, s32 height, s32 compressionLevel);
+
+		// Writes an image that is never fully in memory, 'drawRows(firstRow, rowCount, rgba)' fills a band of rows at a time
+		// and the band is deflated and written before the next one is drawn.
+		static bool WriteRows(const std::string& path, s32 width, s32 height, s32 compressionLevel, const std::function<void(s32, s32, u8*)>& drawRows);
+	};
+}
@@ -17,6 +17,11 @@ struct MyTraits : public OpenMesh::DefaultTraits
 		OpenMesh::Attributes::TexCoord2D);
 };
 using TriMesh = OpenMesh::TriMesh_ArrayKernelT<MyTraits>;
+
+// Vertex colors and palette indices go in custom vertex properties, only added when the mesh has them.
+static constexpr const char* VERTEX_COLORS_PROPERTY = "v:unvox_colors";
+static constexpr const char* VERTEX_COLOR_INDICES_PROPERTY = "v:unvox_color_indices";
+
 #include <Unvoxeller/TjunctionsFixer.h>
 
 
@@ -29,6 +34,18 @@ static void convertAiMeshToOpenMesh(UnvoxMesh* aimesh, TriMesh& om)
 	om.request_vertex_normals();
 	om.request_vertex_texcoords2D();
 
+	OpenMesh::VPropHandleT<color> colors;
+	if (aimesh->Colors.size() > 0)
+	{
+		om.add_property(colors, VERTEX_COLORS_PROPERTY);
+	}
+
+	OpenMesh::VPropHandleT<u8> colorIndices;
+	if (aimesh->ColorIndices.size() > 0)
+	{
+		om.add_property(colorIndices, VERTEX_COLOR_INDICES_PROPERTY);
+	}
+
 	// Keep a handle list for adding faces
 	std::vector<TriMesh::VertexHandle> vhandle(aimesh->Vertices.size());
 
@@ -52,17 +69,26 @@ static void convertAiMeshToOpenMesh(UnvoxMesh* aimesh, TriMesh& om)
 			const auto& uv = aimesh->UVs[i];
 			om.set_texcoord2D(vhandle[i], { uv.x, uv.y });
 		}
+
+		if (colors.is_valid())
+		{
+			om.property(colors, vhandle[i]) = aimesh->Colors[i];
+		}
+
+		if (colorIndices.is_valid())
+		{
+			om.property(colorIndices, vhandle[i]) = aimesh->ColorIndices[i];
+		}
 	}
 
 	// Import faces (triangles)
-	for (unsigned int f = 0; f < aimesh->Faces.size(); ++f) 
+	const u32 faceSize = aimesh->IndicesPerFace;
+	std::vector<TriMesh::VertexHandle> fv(faceSize);
+	for (size_t f = 0; f < aimesh->GetFaceCount(); ++f) 
 	{
-		const auto& face = aimesh->Faces[f];
-		std::vector<TriMesh::VertexHandle> fv;
-		fv.reserve(face.Indices.size());
-		for (unsigned int j = 0; j < face.Indices.size(); ++j)
+		for (u32 j = 0; j < faceSize; ++j)
 		{
-			fv.push_back(vhandle[face.Indices[j]]);
+			fv[j] = vhandle[aimesh->GetIndex(f * faceSize + j)];
 		}
 		om.add_face(fv);
 	}
@@ -85,12 +111,21 @@ static void convertOpenMeshToAiMesh(TriMesh& om, UnvoxMesh* aimesh)
 		// You may need to compute or copy UVs before calling this
 	}
 
-	// --- Vertices, normals, texcoords ---
+	// --- Vertices, normals, texcoords, colors (only the ones the mesh had) ---
 	const unsigned int nv = static_cast<unsigned int>(om.n_vertices());
+	const bool hasUVs = aimesh->UVs.size() > 0;
+
+	OpenMesh::VPropHandleT<color> colors;
+	const bool hasColors = om.get_property_handle(colors, VERTEX_COLORS_PROPERTY);
+
+	OpenMesh::VPropHandleT<u8> colorIndices;
+	const bool hasColorIndices = om.get_property_handle(colorIndices, VERTEX_COLOR_INDICES_PROPERTY);
 
 	aimesh->Vertices.resize(nv);
 	aimesh->Normals.resize(nv);
-	aimesh->UVs.resize(nv);
+	aimesh->UVs.resize(hasUVs ? nv : 0);
+	aimesh->Colors.resize(hasColors ? nv : 0);
+	aimesh->ColorIndices.resize(hasColorIndices ? nv : 0);
 
 	// Map from OpenMesh vertex index → aiMesh index
 	std::vector<unsigned int> idxMap(nv);
@@ -106,8 +141,21 @@ static void convertOpenMeshToAiMesh(TriMesh& om, UnvoxMesh* aimesh)
 		aimesh->Normals[idx] = { n[0], n[1], n[2] };
 
 		// UV
-		auto  uv = om.texcoord2D(vh);
-		aimesh->UVs[idx] = { uv[0], uv[1] };
+		if (hasUVs)
+		{
+			auto  uv = om.texcoord2D(vh);
+			aimesh->UVs[idx] = { uv[0], uv[1] };
+		}
+
+		if (hasColors)
+		{
+			aimesh->Colors[idx] = om.property(colors, vh);
+		}
+
+		if (hasColorIndices)
+		{
+			aimesh->ColorIndices[idx] = om.property(colorIndices, vh);
+		}
 
 		idxMap[vh.idx()] = idx++;
 	}
@@ -115,20 +163,17 @@ static void convertOpenMeshToAiMesh(TriMesh& om, UnvoxMesh* aimesh)
 	// --- Faces (triangles) ---
 	const unsigned int nf = static_cast<unsigned int>(om.n_faces());
 
-	aimesh->Faces.resize(nf);
+	aimesh->IndicesPerFace = 3;
+	aimesh->Indices.resize(size_t(nf) * 3);
+	aimesh->Indices16.clear();
 
-	idx = 0;
+	size_t vi = 0;
 	for (auto fh : om.faces())
 	{
-		auto& af = aimesh->Faces[idx];
-		af.Indices.resize(3);
-
-		int vi = 0;
 		for (auto fv_it = om.cfv_iter(fh); fv_it.is_valid(); ++fv_it)
 		{
-			af.Indices[vi++] = idxMap[fv_it->idx()];
+			aimesh->Indices[vi++] = idxMap[fv_it->idx()];
 		}
-		++idx;
 	}
 }
 
@@ -153,76 +198,15 @@ static void collapseDuplicateVertices(TriMesh& mesh)
 	}
 }
 
-// Split edges whenever a vertex lies on their interior (i.e. T-junction):
-static void splitTJunctions(TriMesh& mesh)
-{
-	const float eps2 = 1e-8f;   // squared‐distance threshold
-
-	// Request the attributes we need
-	mesh.request_vertex_normals();
-	mesh.request_vertex_texcoords2D();
-
-	LOG_INFO("T Juntions Fix: vertex count: {0}", mesh.n_vertices());
-	LOG_INFO("T Juntions Fix: edges count: {0}", mesh.n_edges());
-
-	// Iterate every vertex in the mesh
-	for (auto vh : mesh.vertices())
-	{
-		auto  p = mesh.point(vh);
-
-		// For each edge, see if this vertex lies in its interior
-		for (auto eh : mesh.edges())
-		{
-			if (mesh.status(eh).deleted()) continue;
-
-			// Get endpoints of the edge
-			auto heh = mesh.halfedge_handle(eh, 0);
-			auto v0 = mesh.from_vertex_handle(heh);
-			auto v1 = mesh.to_vertex_handle(heh);
-			if (vh == v0 || vh == v1) continue;
-
-			auto p0 = mesh.point(v0);
-			auto p1 = mesh.point(v1);
-			auto dir = p1 - p0;
-			float d2 = dir.sqrnorm();
-			if (d2 < 1e-12f) continue;  // avoid degenerate
-
-			// Project p onto the line p0→p1
-			float t = ((p - p0) | dir) / d2;
-			if (t <= 0.0f || t >= 1.0f) continue;
-
-			OpenMesh::Vec3f proj = p0 + dir * t;
-			if ((proj - p).sqrnorm() > eps2) continue;
-
-			// Fetch normals & UVs so we can interpolate them
-			auto n0 = mesh.normal(v0);
-			auto n1 = mesh.normal(v1);
-			auto uv0 = mesh.texcoord2D(v0);
-			auto uv1 = mesh.texcoord2D(v1);
-
-			// *** THIS is the key ***
-			// Call the overload that takes a Point:
-			TriMesh::VertexHandle new_vh = mesh.split(eh, proj);
-
-			// Now fill in the new vertex’s attributes
-			mesh.set_normal(new_vh, n0 + (n1 - n0) * t);
-			mesh.set_texcoord2D(new_vh, uv0 + (uv1 - uv0) * t);
-
-			// since topology changed, you might want to restart the edge‐loop for this vh
-			break;
-		}
-	}
-}
-
-static void CleanUpMesh(UnvoxMesh* mesh)
+// Without 'parallel' the T-junction search stays on the calling thread (see 'splitTJunctionsFast').
+static void CleanUpMesh(UnvoxMesh* mesh, bool parallel = true)
 {
 	TriMesh om;
 	convertAiMeshToOpenMesh(mesh, om);
 
 	// 2) Weld duplicates + fix T-junctions
 	collapseDuplicateVertices(om);
-	splitTJunctions(om);
-	//splitTJunctionsFast(om);
+	splitTJunctionsFast(om, 1e-4f, parallel);
 
 	// 3) Clean up deletions
 	om.garbage_collection();
@@ -407,6 +391,12 @@ void OptimizeAssimpScene(UnvoxScene* scene)
 	{
 		UnvoxMesh* mesh = scene->Meshes[mi].get();
 
+		// skip non-triangular meshes
+		if (mesh->IndicesPerFace != 3)
+		{
+			continue;
+		}
+
 		// 1) Build interleaved vertex buffer
 		std::vector<VertexOpt> vertices(mesh->Vertices.size());
 
@@ -439,21 +429,11 @@ void OptimizeAssimpScene(UnvoxScene* scene)
 			}
 		}
 
-		// 2) Build index buffer (assume triangles)
-		std::vector<uint32_t> indices;
-		indices.reserve(mesh->Faces.size() * 3);
-
-		for (unsigned int f = 0; f < mesh->Faces.size(); ++f) 
+		// 2) Index buffer
+		std::vector<uint32_t> indices(mesh->GetIndexCount());
+		for (size_t i = 0; i < indices.size(); ++i)
 		{
-			const auto& face = mesh->Faces[f];
-
-			if (face.Indices.size() == 3) 
-			{
-				indices.push_back(face.Indices[0]);
-				indices.push_back(face.Indices[1]);
-				indices.push_back(face.Indices[2]);
-			}
-			// skip non-triangular faces
+			indices[i] = mesh->GetIndex(i);
 		}
 
 		std::vector<uint32_t> remap1(vertices.size());
@@ -541,19 +521,8 @@ void OptimizeAssimpScene(UnvoxScene* scene)
 		}
 
 		// Faces
-		size_t newFaceCount = weldedIdx.size() / 3;
-
-		mesh->Faces.resize(newFaceCount);
-
-		for (unsigned int f = 0; f < mesh->Faces.size(); ++f) 
-		{
-			auto& face = mesh->Faces[f];
-
-			face.Indices.resize(3);
-			face.Indices[0] = weldedIdx[f * 3 + 0];
-			face.Indices[1] = weldedIdx[f * 3 + 1];
-			face.Indices[2] = weldedIdx[f * 3 + 2];
-		}
+		mesh->Indices = std::move(weldedIdx);
+		mesh->Indices16.clear();
 	}
 }
 
@@ -0,0 +1,24 @@
+#pragma once
+#include <Unvoxeller/FaceRect.h>
+#include <vector>
+
+namespace Unvoxeller
+{
+    // Rounds 'size' up to a multiple of 'alignment' (a power of two).
+    inline s32 AlignUp(s32 size, s32 alignment)
+    {
+      return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    class AtlasPackerBase
+    {
+    public:
+      // Places the rects (plus 'border' texels on every side) inside a width x height area, setting 'atlasX' and 'atlasY'
+      // to the first texel of the rect (the border is around it).
+      // Every rect plus its border takes a cell rounded up to 'alignment' texels (a power of two), cells start at multiples of it
+      // (see 'TexturingOptions::AtlasMips').
+      // Rects are expected to be already sorted by the caller (tallest first), packers don't reorder them.
+      // Packing stops at the first rect that doesn't fit, returns how many were placed (== count if all of them fit).
+      virtual size_t Pack(s32 width, s32 height, s32 border, s32 alignment, FaceRect* rects, size_t count) = 0;
+    };
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include <Unvoxeller/FactoryBase.h>
+#include <Unvoxeller/Data/AtlasPackerType.h>
+#include <Unvoxeller/TextureGenerators/AtlasPackers/AtlasPackerBase.h>
+#include <memory>
+
+namespace Unvoxeller
+{
+    class AtlasPackerFactory : public FactoryBase_T<AtlasPackerType, std::shared_ptr<AtlasPackerBase>>
+    {
+    public:
+        AtlasPackerFactory();
+    };
+}
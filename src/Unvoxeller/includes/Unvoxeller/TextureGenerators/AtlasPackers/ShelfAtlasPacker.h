@@ -0,0 +1,11 @@
+#pragma once
+#include "AtlasPackerBase.h"
+
+namespace Unvoxeller
+{
+    class ShelfAtlasPacker : public AtlasPackerBase
+    {
+    public:
+        size_t Pack(s32 width, s32 height, s32 border, s32 alignment, FaceRect* rects, size_t count) override;
+    };
+}
@@ -2,24 +2,38 @@
 
 #include "TextureGeneratorBase.h"
 #include <Unvoxeller/FaceRect.h>
+#include <Unvoxeller/TextureGenerators/AtlasPackers/AtlasPackerFactory.h>
+#include <array>
+#include <functional>
+#include <memory>
 
 namespace Unvoxeller
 {
+    // Model of a 'FaceRect::modelIndex' and the RGBA of every color index (1–255) it is drawn with, faces of several files can be packed together.
+    // Colors are shared by the models of a palette and kept alive by the pages that draw later (see 'ExportOptions::StreamTextures').
+    struct AtlasModel
+    {
+        const vox_model* Model = nullptr;
+        std::shared_ptr<const std::array<u32, 256>> Colors = nullptr;
+    };
+
     class AtlasTextureGenerator : public TextureGeneratorBase
     {
     public:
-        std::shared_ptr<TextureData> GetTexture(std::vector<FaceRect>& faces, const std::vector<color>& palette,
-                                                      const std::vector<vox_model>& models, const bool texturesPOT) override;
+        std::vector<std::shared_ptr<TextureData>> GetTextures(std::vector<FaceRect>& faces, const std::vector<color>& palette,
+                                                      const std::vector<vox_model>& models, const TexturingOptions& options) override;
+
+        std::vector<std::shared_ptr<TextureData>> GetBatchTextures(std::vector<TextureBatchFile>& files, const TexturingOptions& options) override;
     private:
-        bool PackFacesIntoAtlas(s32 atlasSize, std::vector<FaceRect>& rects);
+        AtlasPackerFactory _packerFactory;
 
-        void GenerateAtlasImage(s32 texWidth,
-                                s32 texHeight,
-                                const std::vector<FaceRect>& faces,
-                                const std::vector<vox_model>& models,
-                                const std::vector<color>& palette,
-                                std::vector<unsigned char>& outImage);
+        std::vector<std::shared_ptr<TextureData>> GetAtlasTextures(std::vector<FaceRect>& faces, const std::vector<AtlasModel>& models, const TexturingOptions& options);
 
+        // Packs the (already sorted) faces in as many atlas pages as needed. Pages only get 'TextureData::DrawRows', the caller draws them.
+        std::vector<std::shared_ptr<TextureData>> PackPages(std::vector<FaceRect>& faces, const std::vector<AtlasModel>& models, const TexturingOptions& options);
 
+        // Draws 'rowCount' rows of the page from 'firstRow' (cleared first), the faces are copied so it can be called after packing.
+        std::function<void(s32, s32, u8*)> GetPageDrawer(s32 texWidth, s32 page, s32 border, s32 alignment,
+                                                         const std::vector<FaceRect>& faces, const std::vector<AtlasModel>& models);
     };
 }
\ No newline at end of file
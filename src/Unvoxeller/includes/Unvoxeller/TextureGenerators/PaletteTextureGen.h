@@ -0,0 +1,15 @@
+#pragma once
+
+#include "TextureGeneratorBase.h"
+#include <Unvoxeller/FaceRect.h>
+
+namespace Unvoxeller
+{
+    // One texel per palette color, laid out as 'TexturingOptions::Palette' says, faces must be single colored (see PaletteMesher).
+    class PaletteTextureGenerator : public TextureGeneratorBase
+    {
+    public:
+        std::vector<std::shared_ptr<TextureData>> GetTextures(std::vector<FaceRect>& faces, const std::vector<color>& palette,
+                                                      const std::vector<vox_model>& models, const TexturingOptions& options) override;
+    };
+}
@@ -2,17 +2,34 @@
 #include <Unvoxeller/Data/TextureData.h>
 #include <Unvoxeller/FaceRect.h>
 #include <Unvoxeller/VoxelTypes.h>
+#include <Unvoxeller/Data/ConvertOptions.h>
 
 #include <memory>
 #include <vector>
 
 namespace Unvoxeller
 {
+    // Faces of one of the files sharing textures, drawn with the file's own models and palette.
+    struct TextureBatchFile
+    {
+      std::vector<FaceRect>* Faces = nullptr;
+      const std::vector<color>* Palette = nullptr;
+      const std::vector<vox_model>* Models = nullptr;
+    };
+
     class TextureGeneratorBase
     {
     public:
-      virtual std::shared_ptr<TextureData> GetTexture(std::vector<FaceRect>& faces, const std::vector<color>& palette,
-                                                      const std::vector<vox_model>& models, const bool texturesPOT) = 0;
+      // Textures for the faces, sets the faces' texture location. Several textures are returned if faces don't fit in one.
+      virtual std::vector<std::shared_ptr<TextureData>> GetTextures(std::vector<FaceRect>& faces, const std::vector<color>& palette,
+                                                      const std::vector<vox_model>& models, const TexturingOptions& options) = 0;
+
+      // Same as 'GetTextures' for the faces of several files at once, so all of them share the textures.
+      // Generators that can't mix files return no textures.
+      virtual std::vector<std::shared_ptr<TextureData>> GetBatchTextures(std::vector<TextureBatchFile>& /*files*/, const TexturingOptions& /*options*/)
+      {
+        return {};
+      }
     private:
     
     };
@@ -1,178 +1,245 @@
-#include <OpenMesh/Core/IO/MeshIO.hh>
+#pragma once
 #include <OpenMesh/Core/Mesh/TriMesh_ArrayKernelT.hh>
-#include <unordered_map>
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/ParallelFor.h>
+#include <Unvoxeller/Log/Log.h>
+#include <algorithm>
 #include <vector>
-#include <array>
-#include <cmath> 
-
-//---------------------------------------------------------------------------
-// Typedefs
-//---------------------------------------------------------------------------
-
-//using TriMesh = OpenMesh::TriMesh_ArrayKernelT<>;
-using Vec3f   = OpenMesh::Vec3f;
-using EHandle = TriMesh::EdgeHandle;
-using VHandle = TriMesh::VertexHandle;
-using Point   = TriMesh::Point;
-
-// 3‐integer key for a grid cell
-struct GridKey {
-    int x, y, z;
-    bool operator==(GridKey const& o) const {
-        return x==o.x && y==o.y && z==o.z;
-    }
-};
+#include <cmath>
+
+// Needs 'TriMesh' (see 'ScenePostprocessing.h') with vertex normals, 2D texcoords, statuses and the color property names.
 
-// Hash for GridKey
-struct GridKeyHash {
-    size_t operator()(GridKey const& k) const noexcept {
-        // Classic 3D hashing
-        size_t h = std::hash<int>()(k.x);
-        h = h * 31 + std::hash<int>()(k.y);
-        h = h * 31 + std::hash<int>()(k.z);
-        return h;
-    }
+// Vertex that lies inside a boundary edge, 't' is where along halfedge 0 of the edge.
+struct TJunctionSplit
+{
+	s32 Edge;
+	f32 T;
+	TriMesh::Point Position;
 };
 
-//---------------------------------------------------------------------------
-// Helper: compute grid key from point
-//---------------------------------------------------------------------------
+// Grid cell, 21 bits per axis.
+static u64 GetTJunctionCell(s64 x, s64 y, s64 z)
+{
+	constexpr s64 OFFSET = 1 << 20;
+	constexpr s64 MASK = (1 << 21) - 1;
+
+	return (u64(std::clamp<s64>(x + OFFSET, 0, MASK)) << 42) | (u64(std::clamp<s64>(y + OFFSET, 0, MASK)) << 21) | u64(std::clamp<s64>(z + OFFSET, 0, MASK));
+}
+
+// Voxel vertices sit on whole and half units, the cells are offset by an odd fraction so they don't fall on cell borders, where their edges would go in both cells.
+static constexpr f32 TJUNCTION_CELL_OFFSET = 0.3183f;
+
+static s64 GetTJunctionCellCoord(f32 coord, f32 invCellSize)
+{
+	return s64(std::floor(coord * invCellSize + TJUNCTION_CELL_OFFSET));
+}
 
-static GridKey key_of(const Vec3f &p, float inv_cell) {
-    return {
-        int(std::floor(p[0] * inv_cell)),
-        int(std::floor(p[1] * inv_cell)),
-        int(std::floor(p[2] * inv_cell))
-    };
+static u64 GetTJunctionCell(const TriMesh::Point& p, f32 invCellSize)
+{
+	return GetTJunctionCell(GetTJunctionCellCoord(p[0], invCellSize), GetTJunctionCellCoord(p[1], invCellSize), GetTJunctionCellCoord(p[2], invCellSize));
 }
 
-//---------------------------------------------------------------------------
-// Main function
-//---------------------------------------------------------------------------
-
-void splitTJunctionsFast(TriMesh& mesh, float eps = 1e-4f) {
-    using EHandle = TriMesh::EdgeHandle;
-    using VHandle = TriMesh::VertexHandle;
-    using Point = TriMesh::Point;
-
-    // 1) Request and compute normals (for interpolation)
-    mesh.request_vertex_normals();
-    mesh.request_vertex_texcoords2D();
-    mesh.update_normals();
-
-    // 2) Collect boundary edges
-    std::vector<EHandle> bEdges;
-    bEdges.reserve(mesh.n_edges() / 10);
-    for (auto eh : mesh.edges()) {
-        if (!mesh.status(eh).deleted() && mesh.is_boundary(eh))
-            bEdges.push_back(eh);
-    }
-    if (bEdges.empty()) {
-        mesh.release_vertex_normals();
-        mesh.release_vertex_texcoords2D();
-        return;
-    }
-
-    // 3) Compute average boundary‐edge length → cell size
-    double sumLen = 0.0;
-    for (auto eh : bEdges) {
-        auto heh = mesh.halfedge_handle(eh, 0);
-        auto p0 = mesh.point(mesh.from_vertex_handle(heh));
-        auto p1 = mesh.point(mesh.to_vertex_handle(heh));
-        sumLen += (p1 - p0).norm();
-    }
-    float avgLen = float(sumLen / bEdges.size());
-    float cell_size = avgLen * 2.0f;        // tweak as desired
-    float inv_cell = 1.0f / cell_size;
-    float eps2 = eps * eps;
-
-    // 4) Build the uniform‐grid: map cell → boundary‐edge list
-    std::unordered_map<GridKey, std::vector<EHandle>, GridKeyHash> grid;
-    grid.reserve(bEdges.size() * 2);
-    for (auto eh : bEdges) {
-        auto heh = mesh.halfedge_handle(eh, 0);
-        Point p0 = mesh.point(mesh.from_vertex_handle(heh));
-        Point p1 = mesh.point(mesh.to_vertex_handle(heh));
-        Point minb = p0.minimize(p1) - Point(eps, eps, eps);
-        Point maxb = p0.maximize(p1) + Point(eps, eps, eps);
-
-        GridKey k0 = key_of(minb, inv_cell);
-        GridKey k1 = key_of(maxb, inv_cell);
-        for (int x = k0.x; x <= k1.x; ++x)
-            for (int y = k0.y; y <= k1.y; ++y)
-                for (int z = k0.z; z <= k1.z; ++z) {
-                    grid[{x, y, z}].push_back(eh);
-                }
-    }
-
-    // 5) Detect phase (parallel, early‐exit per vertex)
-    struct SplitOp { EHandle eh; Point pos; float t; };
-    std::vector<SplitOp> ops;
-    ops.reserve(mesh.n_vertices() / 10);
-
-#pragma omp parallel
-    {
-        std::vector<SplitOp> local_ops;
-#pragma omp for schedule(dynamic)
-        for (int vidx = 0; vidx < (int)mesh.n_vertices(); ++vidx) {
-            auto vh = mesh.vertex_handle(vidx);
-            if (mesh.status(vh).deleted()) continue;
-
-            Point p = mesh.point(vh);
-            GridKey kc = key_of(p, inv_cell);
-            bool found = false;
-
-            for (int dx = -1; dx <= 1 && !found; ++dx)
-                for (int dy = -1; dy <= 1 && !found; ++dy)
-                    for (int dz = -1; dz <= 1 && !found; ++dz) {
-                        GridKey k{ kc.x + dx, kc.y + dy, kc.z + dz };
-                        auto it = grid.find(k);
-                        if (it == grid.end()) continue;
-
-                        for (auto eh : it->second) {
-                            if (mesh.status(eh).deleted()) continue;
-                            auto heh = mesh.halfedge_handle(eh, 0);
-                            auto v0 = mesh.from_vertex_handle(heh);
-                            auto v1 = mesh.to_vertex_handle(heh);
-                            if (vh == v0 || vh == v1) continue;
-
-                            Point p0 = mesh.point(v0), p1 = mesh.point(v1);
-                            auto dir = p1 - p0;
-                            float d2 = dir.sqrnorm();
-                            if (d2 < 1e-12f) continue;
-
-                            float t = ((p - p0) | dir) / d2;
-                            if (t <= 0.0f || t >= 1.0f) continue;
-
-                            Point proj = p0 + dir * t;
-                            if ((proj - p).sqrnorm() > eps2) continue;
-
-                            local_ops.push_back({ eh, proj, t });
-                            found = true;
-                            break;
-                        }
-                    }
-        }
-#pragma omp critical
-        ops.insert(ops.end(), local_ops.begin(), local_ops.end());
-    }
-
-    // 6) Split phase (sequential to avoid iterator invalidation)
-    for (auto& op : ops) {
-        if (mesh.status(op.eh).deleted()) continue;
-        auto heh = mesh.halfedge_handle(op.eh, 0);
-        auto v0 = mesh.from_vertex_handle(heh);
-        auto v1 = mesh.to_vertex_handle(heh);
-
-        auto n0 = mesh.normal(v0), n1 = mesh.normal(v1);
-        auto uv0 = mesh.texcoord2D(v0), uv1 = mesh.texcoord2D(v1);
-
-        auto new_vh = mesh.split(op.eh, op.pos);
-        mesh.set_normal(new_vh, n0 + (n1 - n0) * op.t);
-        mesh.set_texcoord2D(new_vh, uv0 + (uv1 - uv0) * op.t);
-    }
-
-    // 7) Clean up
-    mesh.release_vertex_normals();
-    mesh.release_vertex_texcoords2D();
-}
\ No newline at end of file
+// Splits the boundary edges that have a vertex inside them (T-junctions), so both sides share it and rasterization leaves no cracks.
+// On a closed surface the long edge of a T-junction has no face on the other side, so only boundary edges and vertices are checked.
+// The edges go in a uniform grid (sorted cell list) and every vertex only checks the edges of its own cell, the search runs on worker threads.
+// Normals and uvs of the new vertices are interpolated along the edge, colors and palette indices come from the closest end.
+// 'eps' is how far from an edge a vertex can be. Without 'parallel' the search stays on the calling thread (ex: meshes already spread over workers).
+static void splitTJunctionsFast(TriMesh& mesh, f32 eps = 1e-4f, bool parallel = true)
+{
+	using EHandle = TriMesh::EdgeHandle;
+	using VHandle = TriMesh::VertexHandle;
+	using Point = TriMesh::Point;
+
+	// Boundary edges, with their points so the search doesn't go through the mesh connectivity
+	struct EdgeSegment
+	{
+		Point P0;
+		Point Dir;
+		VHandle V0, V1;
+		s32 Edge;
+	};
+
+	std::vector<EdgeSegment> segments{};
+	f64 segmentsLength = 0.0;
+	for (auto eh : mesh.edges())
+	{
+		if (!mesh.status(eh).deleted() && mesh.is_boundary(eh))
+		{
+			const auto heh = mesh.halfedge_handle(eh, 0);
+			const VHandle v0 = mesh.from_vertex_handle(heh);
+			const VHandle v1 = mesh.to_vertex_handle(heh);
+			const Point p0 = mesh.point(v0);
+			segments.push_back({ p0, mesh.point(v1) - p0, v0, v1, eh.idx() });
+			segmentsLength += segments.back().Dir.norm();
+		}
+	}
+
+	if (segments.empty())
+	{
+		return;
+	}
+
+	// Cells about the average edge, so an edge spans a couple of them and a cell has a few edges
+	const f32 cellSize = std::max(f32(segmentsLength / segments.size()), eps * 4.0f);
+	const f32 invCellSize = 1.0f / cellSize;
+
+	// Every edge goes in the cells its bounds (grown by eps) touch, vertices close enough to it are always in one of them.
+	struct CellEdge
+	{
+		u64 Cell;
+		s32 Segment;
+	};
+
+	std::vector<CellEdge> cells{};
+	cells.reserve(segments.size() * 2);
+	const Point margin(eps, eps, eps);
+
+	for (size_t i = 0; i < segments.size(); ++i)
+	{
+		const Point p0 = segments[i].P0;
+		const Point p1 = p0 + segments[i].Dir;
+		const Point minP = Point(p0).minimize(p1) - margin;
+		const Point maxP = Point(p0).maximize(p1) + margin;
+
+		s64 first[3], last[3];
+		for (s32 a = 0; a < 3; ++a)
+		{
+			first[a] = GetTJunctionCellCoord(minP[a], invCellSize);
+			last[a] = GetTJunctionCellCoord(maxP[a], invCellSize);
+		}
+
+		for (s64 x = first[0]; x <= last[0]; ++x)
+		{
+			for (s64 y = first[1]; y <= last[1]; ++y)
+			{
+				for (s64 z = first[2]; z <= last[2]; ++z)
+				{
+					cells.push_back({ GetTJunctionCell(x, y, z), s32(i) });
+				}
+			}
+		}
+	}
+
+	std::sort(cells.begin(), cells.end(), [](const CellEdge& a, const CellEdge& b)
+	{
+		return a.Cell < b.Cell || (a.Cell == b.Cell && a.Segment < b.Segment);
+	});
+
+	// Search: a vertex can lie on several edges (ex: on a crease, one per side).
+	const size_t vertexCount = mesh.n_vertices();
+	const size_t chunkSize = 4096;
+	const size_t chunkCount = (vertexCount + chunkSize - 1) / chunkSize;
+	const f32 eps2 = eps * eps;
+	std::vector<std::vector<TJunctionSplit>> chunkSplits(chunkCount);
+
+	Unvoxeller::ParallelFor(chunkCount, parallel ? 1 : chunkCount, [&](size_t chunk)
+	{
+		const size_t end = std::min(vertexCount, (chunk + 1) * chunkSize);
+		for (size_t v = chunk * chunkSize; v < end; ++v)
+		{
+			const VHandle vh = mesh.vertex_handle(s32(v));
+			if (mesh.status(vh).deleted() || !mesh.is_boundary(vh))
+			{
+				continue;
+			}
+
+			const Point p = mesh.point(vh);
+			const u64 cell = GetTJunctionCell(p, invCellSize);
+			auto it = std::lower_bound(cells.begin(), cells.end(), cell, [](const CellEdge& c, u64 key) { return c.Cell < key; });
+
+			for (; it != cells.end() && it->Cell == cell; ++it)
+			{
+				const EdgeSegment& segment = segments[it->Segment];
+				if (vh == segment.V0 || vh == segment.V1)
+				{
+					continue;
+				}
+
+				const f32 length2 = segment.Dir.sqrnorm();
+				if (length2 < 1e-12f)
+				{
+					continue;
+				}
+
+				// Inside the edge, vertices on its ends (or at the same place) aren't T-junctions
+				const f32 t = ((p - segment.P0) | segment.Dir) / length2;
+				const f32 inset = eps / std::sqrt(length2);
+				if (t <= inset || t >= 1.0f - inset)
+				{
+					continue;
+				}
+
+				const Point projected = segment.P0 + segment.Dir * t;
+				if ((projected - p).sqrnorm() <= eps2)
+				{
+					chunkSplits[chunk].push_back({ segment.Edge, t, projected });
+				}
+			}
+		}
+	});
+
+	std::vector<TJunctionSplit> splits{};
+	for (const auto& chunk : chunkSplits)
+	{
+		splits.insert(splits.end(), chunk.begin(), chunk.end());
+	}
+
+	std::sort(splits.begin(), splits.end(), [](const TJunctionSplit& a, const TJunctionSplit& b)
+	{
+		return a.Edge < b.Edge || (a.Edge == b.Edge && a.T < b.T);
+	});
+
+	OpenMesh::VPropHandleT<color> colors;
+	const bool hasColors = mesh.get_property_handle(colors, VERTEX_COLORS_PROPERTY);
+
+	OpenMesh::VPropHandleT<u8> colorIndices;
+	const bool hasColorIndices = mesh.get_property_handle(colorIndices, VERTEX_COLOR_INDICES_PROPERTY);
+
+	// Split: the edges are split from their start, every split leaves the rest of the edge between the new vertex and the end.
+	size_t splitCount = 0;
+	for (size_t i = 0; i < splits.size();)
+	{
+		const s32 edge = splits[i].Edge;
+		const auto heh = mesh.halfedge_handle(mesh.edge_handle(edge), 0);
+		const VHandle v0 = mesh.from_vertex_handle(heh);
+		const VHandle v1 = mesh.to_vertex_handle(heh);
+		const auto n0 = mesh.normal(v0), n1 = mesh.normal(v1);
+		const auto uv0 = mesh.texcoord2D(v0), uv1 = mesh.texcoord2D(v1);
+		const f32 length = mesh.calc_edge_length(mesh.edge_handle(edge));
+
+		EHandle current = mesh.edge_handle(edge);
+		f32 lastT = 0.0f;
+
+		for (; i < splits.size() && splits[i].Edge == edge; ++i)
+		{
+			const TJunctionSplit& split = splits[i];
+
+			// Vertices at the same place share the split
+			if ((split.T - lastT) * length <= eps || !current.is_valid())
+			{
+				continue;
+			}
+
+			const VHandle vh = mesh.split(current, split.Position);
+			mesh.set_normal(vh, n0 + (n1 - n0) * split.T);
+			mesh.set_texcoord2D(vh, uv0 + (uv1 - uv0) * split.T);
+
+			const VHandle closest = split.T < 0.5f ? v0 : v1;
+			if (hasColors)
+			{
+				mesh.property(colors, vh) = mesh.property(colors, closest);
+			}
+
+			if (hasColorIndices)
+			{
+				mesh.property(colorIndices, vh) = mesh.property(colorIndices, closest);
+			}
+
+			current = mesh.edge_handle(mesh.find_halfedge(vh, v1));
+			lastT = split.T;
+			++splitCount;
+		}
+	}
+
+	LOG_INFO("T-junctions: boundary edges: {0}, splits: {1}", segments.size(), splitCount);
+}
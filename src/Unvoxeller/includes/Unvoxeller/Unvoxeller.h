@@ -24,11 +24,17 @@ namespace Unvoxeller
 		ExportResults ExportVoxToModel(const ExportOptions& eOptions, const ConvertOptions& cOptions);
 		ExportResults ExportVoxToModel(const char* buffer, int size, const ExportOptions& options);
 		
+		// Exports every file with one atlas shared by all of them, saved once and named after 'OutputName'. Model files are named after their vox file.
+		ExportResults ExportVoxBatchToModels(const std::vector<std::string>& inVoxPaths, const ExportOptions& eOptions, const ConvertOptions& cOptions);
+
 		ExportResults ExportScene(const ExportOptions& eOptions, const ConvertOptions& cOptions, const std::weak_ptr<UnvoxScene> scene);
 
 		ConvertResult VoxToMem(const std::string& inVoxPath, const ConvertOptions& options);
 		ConvertResult VoxToMem(const char* buffer, int size, const ConvertOptions& options);
 
+		// One result per file, all of them sharing the atlas textures.
+		std::vector<ConvertResult> VoxBatchToMem(const std::vector<std::string>& inVoxPaths, const ConvertOptions& options);
+
 		void ExportVoxToModelAsync(const char* buffer, int size, const ExportOptions& options, std::function<void(ExportResults)> callback);
 		void GetModelFromVOXMeshAsync(const char* buffer, int size, const ConvertOptions& options, std::function<void(ConvertResult)> callback);
 
@@ -0,0 +1,17 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/Data/UnvoxMesh.h>
+
+namespace Unvoxeller
+{
+	// Converts mesh vertices between the float arrays and the compact 'UnvoxMesh::Quantized' layout.
+	struct VertexQuantizer
+	{
+		// Moves the float vertices into 'mesh.Quantized'. Positions have to lie on a half unit grid (voxel corners around
+		// half voxel pivots) and span up to 65535 steps, otherwise the mesh is left as it is and false is returned.
+		static bool Quantize(UnvoxMesh& mesh);
+
+		// Float vertices back from 'mesh.Quantized', which gets cleared. Positions are exact, normals and uvs within their 8/16 bit steps.
+		static void Dequantize(UnvoxMesh& mesh);
+	};
+}
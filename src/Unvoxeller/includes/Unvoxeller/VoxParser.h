@@ -1,5 +1,6 @@
 #pragma once
 #include <Unvoxeller/VoxelTypes.h>
+#include <functional>
 
 namespace Unvoxeller
 {
@@ -16,10 +17,13 @@ namespace Unvoxeller
 		// Full file read (all chunks)
 		static std::shared_ptr<vox_file>        read_vox_file(const char* path);
 
-	private:
-		// Index into sizes[] when reading multiple models
-		static s32                              modelIndex;
+		// Called for every XYZI model right after it is decoded, while the rest of the file is still being read.
+		using model_read_callback = std::function<void(s32 modelIndex, const vox_model& model, const vox_size& size)>;
+
+		// Full file read, notifying 'onModelRead' as soon as each model is available (scene graph is resolved at the end).
+		static std::shared_ptr<vox_file>        read_vox_file(const char* path, const model_read_callback& onModelRead);
 
+	private:
 		// Default 256-entry MagicaVoxel palette
 		static const std::vector<u32>  default_palette;
 
@@ -28,8 +32,9 @@ namespace Unvoxeller
 			uint32_t contentBytes, uint32_t childrenBytes);
 		static void parse_SIZE(std::shared_ptr<vox_file>, std::ifstream&,
 			uint32_t contentBytes, uint32_t childrenBytes);
+		// Models take the size at their index (models read so far), 'onModelRead' is the listener of this read, if any.
 		static void parse_XYZI(std::shared_ptr<vox_file>, std::ifstream&,
-			uint32_t contentBytes, uint32_t childrenBytes);
+			uint32_t contentBytes, uint32_t childrenBytes, const model_read_callback& onModelRead);
 		static void parse_RGBA(std::shared_ptr<vox_file>, std::ifstream&,
 			uint32_t contentBytes, uint32_t childrenBytes);
 		static void parse_MATT(std::shared_ptr<vox_file>, std::ifstream&,
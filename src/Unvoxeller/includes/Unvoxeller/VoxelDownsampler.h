@@ -0,0 +1,31 @@
+#pragma once
+#include <Unvoxeller/Types.h>
+#include <Unvoxeller/VoxelTypes.h>
+#include <memory>
+#include <vector>
+
+namespace Unvoxeller
+{
+	// Vox file with its models downsampled, the model grids point into 'Cells' so they live as long as it.
+	struct VoxelMip
+	{
+		std::shared_ptr<vox_file> Data;
+
+		// Per model: the grid cells, [z][y][x], and the slice/row pointers of its 'voxel_3dGrid'.
+		std::vector<std::vector<s32>> Cells;
+		std::vector<std::vector<s32**>> Slices;
+		std::vector<std::vector<s32*>> Rows;
+	};
+
+	// Voxel LODs (see 'LodType::Downsample'): models downsampled 2x by voting over their 2x2x2 blocks.
+	struct VoxelDownsampler
+	{
+		// Copy of 'source' with every model downsampled 2x (odd sizes round up). A block keeps a voxel if at least 'fill' (0 - 1)
+		// of its cells have one, colored with their most common color, models that would end up empty keep every block with a voxel.
+		// Nodes, palette and materials are copied as they are.
+		static std::shared_ptr<VoxelMip> Downsample(const vox_file& source, f32 fill);
+
+		// 'levels' mips, [0] downsampled 2x, [1] 4x... each one from the previous one.
+		static std::vector<std::shared_ptr<VoxelMip>> BuildPyramid(const vox_file& source, s32 levels, f32 fill);
+	};
+}
@@ -143,6 +143,11 @@ namespace Unvoxeller
 		std::unordered_map<s32, vox_MATL>  materials;
 		std::unordered_map<s32, vox_layer> layers;
 		bool                               isValid = false;
+
+		// Downsampled copies (see 'VoxelDownsampler'): every voxel spans 'voxelScale' source voxels a side
+		// and meshes are centered on the source model sizes, so they line up with the source ones.
+		s32                                voxelScale = 1;
+		std::vector<vox_size>              sourceSizes;
 	};
 
 	// Compose transform (parent first!)
@@ -21,24 +21,18 @@ std::shared_ptr<VoxObject> CreateVoxObject(const std::vector<std::shared_ptr<Unv
 			{
 				const auto& vert = mesh->Vertices[i];
 				const auto& normal = mesh->Normals[i];
-				const auto& uv = mesh->UVs[i];
+				const glm::vec2 uv = i < mesh->UVs.size() ? mesh->UVs[i] : glm::vec2{ 0.0f, 0.0f }; // No uvs with vertex colors
 
 				mDesc->Vertices[i] = { {vert.x, vert.y, vert.z}, {normal.x, normal.y, normal.z}, {uv.x, uv.y }};
 			}
 			
 			meshesIdx++;
 
-			mDesc->Indices.resize(mesh->Faces.size() * 3);
-			s32 idx = {};
-			for (size_t i = 0; i < mesh->Faces.size(); i++)
-			{
-				const auto& face = mesh->Faces[i];
+			mDesc->Indices.resize(mesh->GetIndexCount());
 
-				for (size_t j = 0; j < face.Indices.size(); j++)
-				{
-					mDesc->Indices[idx] = face.Indices[j];
-					idx++;
-				}
+			for (size_t i = 0; i < mDesc->Indices.size(); i++)
+			{
+				mDesc->Indices[i] = mesh->GetIndex(i);
 			}
 
 			auto tex = scene->Textures[scene->Materials[mesh->MaterialIndex]->TextureIndex];